@@ -2,6 +2,8 @@ cmake_minimum_required(VERSION 3.28)
 
 include(GNUInstallDirs)
 
+find_package(Threads REQUIRED)
+
 function(RegisterPublicPackage PACKAGE_NAME)
   message(STATUS "Registering public package '${PACKAGE_NAME}'")
 
@@ -18,6 +20,7 @@ function(RegisterPublicPackage PACKAGE_NAME)
   )
 
   target_include_directories(${PACKAGE_NAME} PRIVATE packages)
+  target_link_libraries(${PACKAGE_NAME} PUBLIC Threads::Threads)
 
   install(
           TARGETS ${PACKAGE_NAME}
@@ -30,7 +33,19 @@ function(RegisterPublicPackage PACKAGE_NAME)
   install(
           EXPORT ${PACKAGE_NAME}
           DESTINATION share/${PACKAGE_NAME}
-          FILE ${PACKAGE_NAME}Config.cmake
+          FILE ${PACKAGE_NAME}Targets.cmake
           NAMESPACE SourceParsers::
   )
+
+  # The exported targets link Threads::Threads, so the config has to find it before including them
+  file(
+          WRITE "${CMAKE_CURRENT_BINARY_DIR}/${PACKAGE_NAME}Config.cmake"
+          "include(CMakeFindDependencyMacro)\n"
+          "find_dependency(Threads)\n"
+          "include(\"\${CMAKE_CURRENT_LIST_DIR}/${PACKAGE_NAME}Targets.cmake\")\n"
+  )
+  install(
+          FILES "${CMAKE_CURRENT_BINARY_DIR}/${PACKAGE_NAME}Config.cmake"
+          DESTINATION share/${PACKAGE_NAME}
+  )
 endfunction()
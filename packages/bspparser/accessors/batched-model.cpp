@@ -0,0 +1,313 @@
+#include "./batched-model.hpp"
+#include "./face-accessors.hpp"
+#include "../helpers/get-vertex-position.hpp"
+#include <array>
+#include <bit>
+#include <limits>
+#include <map>
+#include <unordered_map>
+#include <utility>
+#include <source-parsers-shared/internal/parallel-for.hpp>
+
+namespace BspParser::Accessors {
+  namespace {
+    constexpr auto NO_SOURCE_VERTEX = std::numeric_limits<uint32_t>::max();
+    constexpr uint64_t FNV_OFFSET_BASIS = 0xcbf29ce484222325;
+    constexpr uint64_t FNV_PRIME = 0x100000001b3;
+
+    /**
+     * Identifies a vertex for welding, by its index in the vertices lump and the exact bits of its other attributes.
+     */
+    struct WeldKey {
+      uint32_t sourceVertex;
+      std::array<uint32_t, 9> attributes;
+
+      bool operator==(const WeldKey&) const = default;
+    };
+
+    struct WeldKeyHasher {
+      size_t operator()(const WeldKey& key) const noexcept {
+        auto hash = FNV_OFFSET_BASIS;
+        hash = (hash ^ key.sourceVertex) * FNV_PRIME;
+        for (const auto attribute : key.attributes) {
+          hash = (hash ^ attribute) * FNV_PRIME;
+        }
+
+        return static_cast<size_t>(hash);
+      }
+    };
+
+    WeldKey getWeldKey(const uint32_t sourceVertex, const Vertex& vertex) {
+      return {
+        .sourceVertex = sourceVertex,
+        .attributes = {
+          std::bit_cast<uint32_t>(vertex.normal.x),
+          std::bit_cast<uint32_t>(vertex.normal.y),
+          std::bit_cast<uint32_t>(vertex.normal.z),
+          std::bit_cast<uint32_t>(vertex.tangent.x),
+          std::bit_cast<uint32_t>(vertex.tangent.y),
+          std::bit_cast<uint32_t>(vertex.tangent.z),
+          std::bit_cast<uint32_t>(vertex.tangent.w),
+          std::bit_cast<uint32_t>(vertex.uv.x),
+          std::bit_cast<uint32_t>(vertex.uv.y),
+        },
+      };
+    }
+
+    /**
+     * Merges identical vertices within each batch, shrinking the vertex buffer and moving batches down to match.
+     * @param batched Batched model to weld in place.
+     * @param sourceVertices Index in the vertices lump of each vertex, or NO_SOURCE_VERTEX to never weld it.
+     * @param threadCount Number of threads to weld batches with.
+     */
+    void weldBatches(
+      BatchedModel& batched,
+      const std::span<const uint32_t> sourceVertices,
+      const unsigned int threadCount
+    ) {
+      // Local indices of the vertices each batch keeps, in their original order
+      std::vector<std::vector<uint32_t>> keptVertices(batched.batches.size());
+
+      SourceParsers::Internal::parallelFor(batched.batches.size(), threadCount, [&](const size_t batchIndex) {
+        const auto& batch = batched.batches[batchIndex];
+        auto& kept = keptVertices[batchIndex];
+        std::vector<uint32_t> remap(batch.vertexCount);
+        std::unordered_map<WeldKey, uint32_t, WeldKeyHasher> welded;
+        welded.reserve(batch.vertexCount);
+
+        for (uint32_t vertex = 0; vertex < batch.vertexCount; vertex++) {
+          const auto sourceVertex = sourceVertices[batch.firstVertex + vertex];
+          const auto nextVertex = static_cast<uint32_t>(kept.size());
+
+          if (sourceVertex == NO_SOURCE_VERTEX) {
+            remap[vertex] = nextVertex;
+            kept.push_back(vertex);
+            continue;
+          }
+
+          const auto [it, inserted] = welded.try_emplace(
+            getWeldKey(sourceVertex, batched.vertices[batch.firstVertex + vertex]),
+            nextVertex
+          );
+          if (inserted) {
+            kept.push_back(vertex);
+          }
+          remap[vertex] = it->second;
+        }
+
+        // Indices are left relative to the batch until its new place in the vertex buffer is known
+        for (auto& index : std::span(batched.indices).subspan(batch.firstIndex, batch.indexCount)) {
+          index = remap[index - batch.firstVertex];
+        }
+      });
+
+      std::vector<uint32_t> oldFirstVertices(batched.batches.size());
+      uint32_t vertexCount = 0;
+      for (size_t batchIndex = 0; batchIndex < batched.batches.size(); batchIndex++) {
+        auto& batch = batched.batches[batchIndex];
+        oldFirstVertices[batchIndex] = batch.firstVertex;
+        batch.firstVertex = vertexCount;
+        batch.vertexCount = static_cast<uint32_t>(keptVertices[batchIndex].size());
+        vertexCount += batch.vertexCount;
+      }
+
+      std::vector<Vertex> vertices(vertexCount);
+      SourceParsers::Internal::parallelFor(batched.batches.size(), threadCount, [&](const size_t batchIndex) {
+        const auto& batch = batched.batches[batchIndex];
+        const auto& kept = keptVertices[batchIndex];
+
+        for (size_t vertex = 0; vertex < kept.size(); vertex++) {
+          vertices[batch.firstVertex + vertex] = batched.vertices[oldFirstVertices[batchIndex] + kept[vertex]];
+        }
+        for (auto& index : std::span(batched.indices).subspan(batch.firstIndex, batch.indexCount)) {
+          index += batch.firstVertex;
+        }
+      });
+
+      batched.vertices = std::move(vertices);
+    }
+
+    /**
+     * Running totals of a batch while faces are counted and then placed.
+     */
+    struct BatchCounts {
+      size_t vertexCount = 0;
+      size_t indexCount = 0;
+      /**
+       * Position for the next face's vertices, once the batch's place in the buffers is known.
+       */
+      size_t nextVertex = 0;
+      size_t nextIndex = 0;
+    };
+
+    struct FaceEntry {
+      const Structs::Face* face;
+      const Structs::Plane* plane;
+      const Structs::TexInfo* textureInfo;
+      std::span<const int32_t> surfaceEdges;
+      BatchCounts* batch;
+      size_t vertexCount;
+      size_t firstVertex;
+      size_t firstIndex;
+    };
+  }
+
+  BatchedModel buildBatchedModel(const Bsp& bsp, const Structs::Model& model, const BatchedModelOptions& options) {
+    // Count the vertices and indices of each batch, keyed so batches come out sorted
+    std::map<std::pair<int32_t, uint32_t>, BatchCounts> batchCounts;
+    std::vector<FaceEntry> faces;
+
+    iterateFaces(
+      bsp,
+      model,
+      [&](
+        const Structs::Face& face,
+        const Structs::Plane& plane,
+        const Structs::TexInfo& textureInfo,
+        const std::span<const int32_t> surfaceEdges
+      ) {
+        if (options.faceFilter && !options.faceFilter(face, textureInfo)) {
+          return;
+        }
+
+        if (textureInfo.texData < 0 || static_cast<size_t>(textureInfo.texData) >= bsp.textureDatas.size()) {
+          throw Errors::OutOfBoundsAccess(
+            Enums::Lump::TextureInfo,
+            std::format(
+              "Texture info's texture data index '{}' is out of bounds of the texture data lump", textureInfo.texData
+            )
+          );
+        }
+
+        if (face.dispInfo >= 0 && static_cast<size_t>(face.dispInfo) >= bsp.displacements.size()) {
+          throw Errors::OutOfBoundsAccess(
+            Enums::Lump::Faces,
+            std::format("Face displacement index '{}' is out of bounds of the displacements", face.dispInfo)
+          );
+        }
+
+        const auto lightmapPage = options.getLightmapPage ? options.getLightmapPage(face) : 0;
+        auto& batch = batchCounts[{ textureInfo.texData, lightmapPage }];
+        const auto vertexCount = getVertexCount(bsp, face, surfaceEdges);
+
+        batch.vertexCount += vertexCount;
+        batch.indexCount += getTriangleListIndexCount(bsp, face, surfaceEdges);
+        faces.push_back(
+          {
+            .face = &face,
+            .plane = &plane,
+            .textureInfo = &textureInfo,
+            .surfaceEdges = surfaceEdges,
+            .batch = &batch,
+            .vertexCount = vertexCount,
+            .firstVertex = 0,
+            .firstIndex = 0,
+          }
+        );
+      }
+    );
+
+    // Lay the batches out one after another, then hand each face the next slot in its batch
+    BatchedModel batched;
+    batched.batches.reserve(batchCounts.size());
+    size_t vertexCount = 0;
+    size_t indexCount = 0;
+
+    for (auto& [key, batch] : batchCounts) {
+      batch.nextVertex = vertexCount;
+      batch.nextIndex = indexCount;
+      vertexCount += batch.vertexCount;
+      indexCount += batch.indexCount;
+
+      if (vertexCount > UINT32_MAX || indexCount > UINT32_MAX) {
+        throw Errors::OutOfBoundsAccess(Enums::Lump::Faces, "Model is too large for 32 bit indices");
+      }
+
+      batched.batches.push_back(
+        {
+          .textureData = key.first,
+          .lightmapPage = key.second,
+          .firstVertex = static_cast<uint32_t>(batch.nextVertex),
+          .vertexCount = static_cast<uint32_t>(batch.vertexCount),
+          .firstIndex = static_cast<uint32_t>(batch.nextIndex),
+          .indexCount = static_cast<uint32_t>(batch.indexCount),
+        }
+      );
+    }
+
+    for (auto& entry : faces) {
+      entry.firstVertex = entry.batch->nextVertex;
+      entry.firstIndex = entry.batch->nextIndex;
+      entry.batch->nextVertex += entry.vertexCount;
+      entry.batch->nextIndex += getTriangleListIndexCount(bsp, *entry.face, entry.surfaceEdges);
+    }
+
+    batched.vertices.resize(vertexCount);
+    batched.indices.resize(indexCount);
+    std::vector<uint32_t> sourceVertices(options.weldVertices ? vertexCount : 0, NO_SOURCE_VERTEX);
+
+    SourceParsers::Internal::parallelFor(faces.size(), options.threadCount, [&](const size_t faceIndex) {
+      const auto& entry = faces[faceIndex];
+      auto nextVertex = batched.vertices.begin() + static_cast<ptrdiff_t>(entry.firstVertex);
+      auto nextIndex = batched.indices.begin() + static_cast<ptrdiff_t>(entry.firstIndex);
+      const auto baseVertex = static_cast<uint32_t>(entry.firstVertex);
+
+      generateVertices(
+        bsp,
+        *entry.face,
+        *entry.plane,
+        *entry.textureInfo,
+        entry.surfaceEdges,
+        [&](const Vertex& vertex) { *nextVertex++ = vertex; }
+      );
+      generateTriangleListIndices(
+        bsp,
+        *entry.face,
+        entry.surfaceEdges,
+        [&](const uint32_t i0, const uint32_t i1, const uint32_t i2) {
+          *nextIndex++ = baseVertex + i0;
+          *nextIndex++ = baseVertex + i1;
+          *nextIndex++ = baseVertex + i2;
+        }
+      );
+
+      if (options.weldVertices && entry.face->dispInfo < 0) {
+        for (size_t vertex = 0; vertex < entry.surfaceEdges.size(); vertex++) {
+          sourceVertices[entry.firstVertex + vertex] =
+            Internal::getVertexIndex(bsp.edges, bsp.vertices, entry.surfaceEdges[vertex]);
+        }
+      }
+    });
+
+    if (options.weldVertices) {
+      weldBatches(batched, sourceVertices, options.threadCount);
+    }
+
+    if (options.optimisation.has_value()) {
+      // Batches share no vertices, so each is optimised on its own and keeps its vertex range
+      auto batchOptimisation = options.optimisation.value();
+      batchOptimisation.threadCount = 1;
+
+      SourceParsers::Internal::parallelFor(batched.batches.size(), options.threadCount, [&](const size_t batchIndex) {
+        const auto& batch = batched.batches[batchIndex];
+        const auto indices = std::span(batched.indices).subspan(batch.firstIndex, batch.indexCount);
+        const SourceParsers::MeshOptimisation::IndexRange range{ .firstIndex = 0, .indexCount = batch.indexCount };
+
+        for (auto& index : indices) {
+          index -= batch.firstVertex;
+        }
+        SourceParsers::MeshOptimisation::optimiseMesh(
+          indices,
+          std::span(&range, 1),
+          std::span(batched.vertices).subspan(batch.firstVertex, batch.vertexCount),
+          batchOptimisation
+        );
+        for (auto& index : indices) {
+          index += batch.firstVertex;
+        }
+      });
+    }
+
+    return batched;
+  }
+}
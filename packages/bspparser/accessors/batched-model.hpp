@@ -0,0 +1,97 @@
+#pragma once
+
+#include "../bsp.hpp"
+#include "../structs/geometry.hpp"
+#include "../structs/models.hpp"
+#include "../vertex.hpp"
+#include <cstdint>
+#include <functional>
+#include <optional>
+#include <vector>
+#include <source-parsers-shared/mesh-optimisation.hpp>
+
+namespace BspParser::Accessors {
+  /**
+   * A range of a batched model's vertices and indices which is drawn with a single material.
+   */
+  struct MaterialBatch {
+    /**
+     * Index into Bsp::textureDatas shared by every face in the batch.
+     */
+    int32_t textureData;
+    /**
+     * Lightmap page shared by every face in the batch, or 0 when not batching by lightmap page.
+     */
+    uint32_t lightmapPage;
+    uint32_t firstVertex;
+    uint32_t vertexCount;
+    uint32_t firstIndex;
+    uint32_t indexCount;
+  };
+
+  /**
+   * How to batch the faces of a model.
+   */
+  struct BatchedModelOptions {
+    /**
+     * Called with every face to decide whether to include it, such as to leave out nodraw or sky faces. Every face is
+     * included if empty.
+     */
+    std::function<bool(const Structs::Face& face, const Structs::TexInfo& textureInfo)> faceFilter;
+    /**
+     * Called with every included face to get the lightmap page it was packed into, so batches are also split by page.
+     * Batches only by texture data if empty.
+     */
+    std::function<uint32_t(const Structs::Face& face)> getLightmapPage;
+    /**
+     * Whether to merge vertices of brush faces in the same batch which start the same edges and share a normal, tangent
+     * and UV, so neighbouring faces share vertices instead of each having their own. Displacement vertices are kept as
+     * generated.
+     */
+    bool weldVertices = false;
+    /**
+     * Passes to reorder each batch with for faster rendering, or none to keep faces in lump order.
+     */
+    std::optional<SourceParsers::MeshOptimisation::Options> optimisation;
+    /**
+     * Number of threads to generate faces and optimise batches with. 0 uses the number of hardware threads.
+     */
+    unsigned int threadCount = 0;
+  };
+
+  /**
+   * Faces and displacements of a model merged into one vertex buffer and one index buffer, grouped by material.
+   */
+  struct BatchedModel {
+    std::vector<Vertex> vertices;
+    /**
+     * Triangle list indices into vertices (not relative to their batch), with clockwise winding.
+     */
+    std::vector<uint32_t> indices;
+    /**
+     * One batch for each material used, sorted by texture data and then lightmap page.
+     */
+    std::vector<MaterialBatch> batches;
+  };
+
+  /**
+   * Builds every face and displacement of a model into one vertex and index range per material, ready to be drawn
+   * with one draw call each.
+   * @remark Faces are counted per material before anything is generated, so every buffer is allocated once at its exact
+   * @remark size, and faces are then generated straight into place in parallel.
+   * @remark Welding hashes vertices by their index in the vertices lump, found through the edges and surface edges,
+   * @remark along with their other attributes, then compacts each batch in parallel.
+   * @param bsp BSP instance.
+   * @param model Model to build.
+   * @param options How to batch the faces.
+   * @return The batched model, with faces in lump order within each batch unless optimised.
+   * @throws Errors::OutOfBoundsAccess A face refers to data outside its lump, or the model has more vertices or indices
+   * than fit in 32 bits.
+   * @throws std::runtime_error Face cannot be triangulated (less than 3 edges).
+   */
+  [[nodiscard]] BatchedModel buildBatchedModel(
+    const Bsp& bsp,
+    const Structs::Model& model,
+    const BatchedModelOptions& options = {}
+  );
+}
@@ -28,6 +28,8 @@ namespace BspParser {
 }
 
 #include "bsp.hpp"
+#include "quantised-vertices.hpp"
+#include "accessors/batched-model.hpp"
 #include "accessors/face-accessors.hpp"
 #include "accessors/prop-accessors.hpp"
 #include "accessors/texture-accessors.hpp"
@@ -5,7 +5,7 @@
 #include <format>
 
 namespace BspParser::Internal {
-  const Structs::Vector& getVertexPosition(
+  uint16_t getVertexIndex(
     const std::span<const Structs::Edge> edges,
     const std::span<const Structs::Vector> vertices,
     const int32_t surfaceEdge
@@ -27,6 +27,14 @@ namespace BspParser::Internal {
       );
     }
 
-    return vertices[firstVertexIndex];
+    return firstVertexIndex;
+  }
+
+  const Structs::Vector& getVertexPosition(
+    const std::span<const Structs::Edge> edges,
+    const std::span<const Structs::Vector> vertices,
+    const int32_t surfaceEdge
+  ) {
+    return vertices[getVertexIndex(edges, vertices, surfaceEdge)];
   }
 }
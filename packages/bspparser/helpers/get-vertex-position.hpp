@@ -5,6 +5,13 @@
 #include <span>
 
 namespace BspParser::Internal {
+  /**
+   * Gets the index into the vertices lump of the vertex a surface edge starts at.
+   */
+  uint16_t getVertexIndex(
+    std::span<const Structs::Edge> edges, std::span<const Structs::Vector> vertices, int32_t surfaceEdge
+  );
+
   const Structs::Vector& getVertexPosition(
     std::span<const Structs::Edge> edges, std::span<const Structs::Vector> vertices, int32_t surfaceEdge
   );
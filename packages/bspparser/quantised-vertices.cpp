@@ -0,0 +1,23 @@
+#include "quantised-vertices.hpp"
+#include <algorithm>
+#include <cmath>
+
+namespace BspParser {
+  QuantisedVertices quantiseVertices(
+    const std::span<const Vertex> vertices,
+    const std::optional<SourceParsers::VertexQuantisation::PositionBounds>& bounds
+  ) {
+    auto buffer = SourceParsers::VertexQuantisation::quantiseVertexBuffer(vertices, bounds);
+    QuantisedVertices quantised{ .bounds = buffer.bounds, .vertices = std::move(buffer.vertices), .alphas = {} };
+
+    if (std::ranges::any_of(vertices, [](const Vertex& vertex) { return vertex.alpha != 0.f; })) {
+      quantised.alphas.reserve(vertices.size());
+
+      for (const auto& vertex : vertices) {
+        quantised.alphas.push_back(static_cast<uint8_t>(std::lround(std::clamp(vertex.alpha, 0.f, 1.f) * 255.f)));
+      }
+    }
+
+    return quantised;
+  }
+}
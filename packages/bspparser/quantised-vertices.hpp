@@ -0,0 +1,34 @@
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <vector>
+#include <source-parsers-shared/vertex-quantisation.hpp>
+#include "vertex.hpp"
+
+namespace BspParser {
+  /**
+   * Vertices generated from faces and displacements, quantised for upload to the GPU.
+   */
+  struct QuantisedVertices {
+    SourceParsers::VertexQuantisation::PositionBounds bounds;
+    std::vector<SourceParsers::VertexQuantisation::QuantisedVertex> vertices;
+    /**
+     * Displacement blend alpha of each vertex as an 8 bit unsigned normalised value, or empty if every vertex has an
+     * alpha of 0, such as when there are no displacements.
+     */
+    std::vector<uint8_t> alphas;
+  };
+
+  /**
+   * Quantises vertices generated by Accessors::generateVertices, roughly halving their size.
+   * @param vertices Vertices of one or more faces.
+   * @param bounds Bounds to quantise positions relative to, or empty to use the vertices' own bounds.
+   * @return The quantised vertices, in the same order.
+   */
+  [[nodiscard]] QuantisedVertices quantiseVertices(
+    std::span<const Vertex> vertices,
+    const std::optional<SourceParsers::VertexQuantisation::PositionBounds>& bounds = std::nullopt
+  );
+}
@@ -1,14 +1,17 @@
 #include "accessors.hpp"
 #include <source-parsers-shared/errors.hpp>
+#include <source-parsers-shared/internal/check-bounds.hpp>
+#include "helpers/vvd-indices.hpp"
 
 namespace MdlParser::Accessors {
   namespace {
     using namespace SourceParsers::Errors;
+    using namespace SourceParsers::Internal;
 
     template<typename T1, typename T2>
     void iteratePairs(
-      const std::vector<T1>& first,
-      const std::vector<T2>& second,
+      const std::span<const T1> first,
+      const std::span<const T2> second,
       const std::function<void(const T1&, const T2&)>& iteratee
     ) {
       if (first.size() != second.size()) {
@@ -19,6 +22,29 @@ namespace MdlParser::Accessors {
         iteratee(first[i], second[i]);
       }
     }
+
+    template<typename StripGroup>
+    void iterateStripGroupVertices(
+      const Vvd& vvd,
+      const Mdl::Model& model,
+      const Mdl::Mesh& mesh,
+      const StripGroup& stripGroup,
+      const int lod,
+      const std::function<void(const Structs::Vtx::Vertex &, const Structs::Vvd::Vertex &, const Structs::Vector4D &)>&
+      iteratee
+    ) {
+      const auto& vvdVertices = vvd.getVertices(lod);
+      const auto& vvdTangents = vvd.getTangents(lod);
+
+      for (const auto& vtxVertex : stripGroup.vertices) {
+        const auto [vertexIndex, tangentIndex] =
+          getVvdIndices(model, mesh, vtxVertex.origMeshVertId, lod, vvd.hasFixups());
+        checkBounds(vertexIndex, 1, vvdVertices.size(), "VVD vertex index is outside range");
+        checkBounds(tangentIndex, 1, vvdTangents.size(), "VVD tangent index is outside range");
+
+        iteratee(vtxVertex, vvdVertices[vertexIndex], vvdTangents[tangentIndex]);
+      }
+    }
   }
 
   void iterateBodyParts(
@@ -26,7 +52,7 @@ namespace MdlParser::Accessors {
     const Vtx& vtx,
     const std::function<void(const Mdl::BodyPart &, const Vtx::BodyPart &)>& iteratee
   ) {
-    iteratePairs(mdl.getBodyParts(), vtx.getBodyParts(), iteratee);
+    iteratePairs<Mdl::BodyPart, Vtx::BodyPart>(mdl.getBodyParts(), vtx.getBodyParts(), iteratee);
   }
 
   void iterateModels(
@@ -34,7 +60,7 @@ namespace MdlParser::Accessors {
     const Vtx::BodyPart& vtxBodyPart,
     const std::function<void(const Mdl::Model &, const Vtx::Model &)>& iteratee
   ) {
-    iteratePairs(mdlBodyPart.models, vtxBodyPart.models, iteratee);
+    iteratePairs<Mdl::Model, Vtx::Model>(mdlBodyPart.models, vtxBodyPart.models, iteratee);
   }
 
   void iterateMeshes(
@@ -42,7 +68,18 @@ namespace MdlParser::Accessors {
     const Vtx::ModelLod& vtxModel,
     const std::function<void(const Mdl::Mesh &, const Vtx::Mesh &)>& iteratee
   ) {
-    iteratePairs(mdlModel.meshes, vtxModel.meshes, iteratee);
+    iteratePairs<Mdl::Mesh, Vtx::Mesh>(mdlModel.meshes, vtxModel.meshes, iteratee);
+  }
+
+  void iterateVertices(
+    const Vvd& vvd,
+    const Mdl::Model& model,
+    const Mdl::Mesh& mesh,
+    const Vtx::StripGroup& stripGroup,
+    const std::function<void(const Structs::Vtx::Vertex &, const Structs::Vvd::Vertex &, const Structs::Vector4D &)>&
+    iteratee
+  ) {
+    iterateStripGroupVertices(vvd, model, mesh, stripGroup, 0, iteratee);
   }
 
   void iterateVertices(
@@ -50,17 +87,85 @@ namespace MdlParser::Accessors {
     const Mdl::Model& model,
     const Mdl::Mesh& mesh,
     const Vtx::StripGroup& stripGroup,
+    const int lod,
+    const std::function<void(const Structs::Vtx::Vertex &, const Structs::Vvd::Vertex &, const Structs::Vector4D &)>&
+    iteratee
+  ) {
+    iterateStripGroupVertices(vvd, model, mesh, stripGroup, lod, iteratee);
+  }
+
+  void iterateBodyParts(
+    const Mdl& mdl,
+    const VtxView& vtx,
+    const std::function<void(const Mdl::BodyPart &, const VtxView::BodyPart &)>& iteratee
+  ) {
+    iteratePairs<Mdl::BodyPart, VtxView::BodyPart>(mdl.getBodyParts(), vtx.getBodyParts(), iteratee);
+  }
+
+  void iterateModels(
+    const Mdl::BodyPart& mdlBodyPart,
+    const VtxView::BodyPart& vtxBodyPart,
+    const std::function<void(const Mdl::Model &, const VtxView::Model &)>& iteratee
+  ) {
+    iteratePairs<Mdl::Model, VtxView::Model>(mdlBodyPart.models, vtxBodyPart.models, iteratee);
+  }
+
+  void iterateMeshes(
+    const Mdl::Model& mdlModel,
+    const VtxView::ModelLod& vtxModel,
+    const std::function<void(const Mdl::Mesh &, const VtxView::Mesh &)>& iteratee
+  ) {
+    iteratePairs<Mdl::Mesh, VtxView::Mesh>(mdlModel.meshes, vtxModel.meshes, iteratee);
+  }
+
+  void iterateVertices(
+    const Vvd& vvd,
+    const Mdl::Model& model,
+    const Mdl::Mesh& mesh,
+    const VtxView::StripGroup& stripGroup,
+    const std::function<void(const Structs::Vtx::Vertex &, const Structs::Vvd::Vertex &, const Structs::Vector4D &)>&
+    iteratee
+  ) {
+    iterateStripGroupVertices(vvd, model, mesh, stripGroup, 0, iteratee);
+  }
+
+  void iterateVertices(
+    const Vvd& vvd,
+    const Mdl::Model& model,
+    const Mdl::Mesh& mesh,
+    const VtxView::StripGroup& stripGroup,
+    const int lod,
+    const std::function<void(const Structs::Vtx::Vertex &, const Structs::Vvd::Vertex &, const Structs::Vector4D &)>&
+    iteratee
+  ) {
+    iterateStripGroupVertices(vvd, model, mesh, stripGroup, lod, iteratee);
+  }
+
+  void iterateVertices(
+    const VvdView& vvd,
+    const Mdl::Model& model,
+    const Mdl::Mesh& mesh,
+    const VtxView::StripGroup& stripGroup,
     const std::function<void(const Structs::Vtx::Vertex &, const Structs::Vvd::Vertex &, const Structs::Vector4D &)>&
     iteratee
   ) {
-    const auto& vvdVertices = vvd.getVertices();
-    const auto& vvdTangents = vvd.getTangents();
+    iterateVertices(vvd, model, mesh, stripGroup, 0, iteratee);
+  }
 
+  void iterateVertices(
+    const VvdView& vvd,
+    const Mdl::Model& model,
+    const Mdl::Mesh& mesh,
+    const VtxView::StripGroup& stripGroup,
+    const int lod,
+    const std::function<void(const Structs::Vtx::Vertex &, const Structs::Vvd::Vertex &, const Structs::Vector4D &)>&
+    iteratee
+  ) {
     for (const auto& vtxVertex : stripGroup.vertices) {
-      const auto vvdVertexIndex = model.vertexOffset + mesh.vertexOffset + vtxVertex.origMeshVertId;
-      const auto vvdTangentIndex = model.tangentsOffset + mesh.vertexOffset + vtxVertex.origMeshVertId;
+      const auto [vertexIndex, tangentIndex] =
+        getVvdIndices(model, mesh, vtxVertex.origMeshVertId, lod, vvd.hasFixups());
 
-      iteratee(vtxVertex, vvdVertices[vvdVertexIndex], vvdTangents[vvdTangentIndex]);
+      iteratee(vtxVertex, vvd.getVertex(vertexIndex, lod), vvd.getTangent(tangentIndex, lod));
     }
   }
 }
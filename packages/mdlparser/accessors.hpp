@@ -2,7 +2,9 @@
 
 #include <functional>
 #include "mdl.hpp"
+#include "vtx-view.hpp"
 #include "vtx.hpp"
+#include "vvd-view.hpp"
 #include "vvd.hpp"
 
 /**
@@ -47,11 +49,13 @@ namespace MdlParser::Accessors {
 
   /**
    * Iterates over the vertex data for the given strip group, calling iteratee with the VTX and VVD vertex data plus the tangent.
+   * @remark Uses the VVD vertices of the root level of detail.
    * @param vvd Parsed VVD containing per-vertex data.
    * @param model Parsed model from the MDL containing offsets into the VVD.
    * @param mesh Parsed mesh from the MDL containing offsets into the VVD.
    * @param stripGroup VTX strip group to read vertex data from.
    * @param iteratee Function to be called for each vertex, taking the VTX vertex, VVD vertex and tangent (in that order).
+   * @throws Errors::OutOfBoundsAccess A vertex points outside the VVD data.
    */
   void iterateVertices(
     const Vvd& vvd,
@@ -61,4 +65,143 @@ namespace MdlParser::Accessors {
     const std::function<void(const Structs::Vtx::Vertex &, const Structs::Vvd::Vertex &, const Structs::Vector4D &)>&
     iteratee
   );
+
+  /**
+   * Iterates over the vertex data for the given strip group, calling iteratee with the VTX and VVD vertex data plus the tangent.
+   * @param vvd Parsed VVD containing per-vertex data.
+   * @param model Parsed model from the MDL containing offsets into the VVD.
+   * @param mesh Parsed mesh from the MDL containing offsets into the VVD.
+   * @param stripGroup VTX strip group to read vertex data from.
+   * @param lod Level of detail the strip group belongs to. With fixups, its VVD vertices are indexed with the model's
+   * and mesh's per-LoD offsets, as the engine does when that level is its root.
+   * @param iteratee Function to be called for each vertex, taking the VTX vertex, VVD vertex and tangent (in that order).
+   * @throws Errors::OutOfBoundsAccess The level of detail does not exist in the VVD, or a vertex points outside it.
+   */
+  void iterateVertices(
+    const Vvd& vvd,
+    const Mdl::Model& model,
+    const Mdl::Mesh& mesh,
+    const Vtx::StripGroup& stripGroup,
+    int lod,
+    const std::function<void(const Structs::Vtx::Vertex &, const Structs::Vvd::Vertex &, const Structs::Vector4D &)>&
+    iteratee
+  );
+
+  /**
+   * Iterates over the pairs of body parts in the MDL and zero-copy VTX data, calling iteratee with each pair.
+   * @param mdl MDL data.
+   * @param vtx VTX data.
+   * @param iteratee Function to be called for each pair, taking the MDL body part followed by the VTX body part.
+   */
+  void iterateBodyParts(
+    const Mdl& mdl,
+    const VtxView& vtx,
+    const std::function<void(const Mdl::BodyPart &, const VtxView::BodyPart &)>& iteratee
+  );
+
+  /**
+   * Iterates over the pairs of models in the MDL and zero-copy VTX data, calling iteratee with each pair.
+   * @param mdlBodyPart Body part in the MDL data.
+   * @param vtxBodyPart Body part in the VTX data.
+   * @param iteratee Function to be called for each pair, taking the MDL model followed by the VTX model.
+   */
+  void iterateModels(
+    const Mdl::BodyPart& mdlBodyPart,
+    const VtxView::BodyPart& vtxBodyPart,
+    const std::function<void(const Mdl::Model &, const VtxView::Model &)>& iteratee
+  );
+
+  /**
+   * Iterates over the pairs of meshes in the MDL and zero-copy VTX data, calling iteratee with each pair.
+   * @param mdlModel Model in the MDL data.
+   * @param vtxModel Model in the VTX data.
+   * @param iteratee Function to be called for each pair, taking the MDL mesh followed by the VTX mesh.
+   */
+  void iterateMeshes(
+    const Mdl::Model& mdlModel,
+    const VtxView::ModelLod& vtxModel,
+    const std::function<void(const Mdl::Mesh &, const VtxView::Mesh &)>& iteratee
+  );
+
+  /**
+   * Iterates over the vertex data for the given zero-copy strip group, calling iteratee with the VTX and VVD vertex data plus the tangent.
+   * @remark Uses the VVD vertices of the root level of detail.
+   * @param vvd Parsed VVD containing per-vertex data.
+   * @param model Parsed model from the MDL containing offsets into the VVD.
+   * @param mesh Parsed mesh from the MDL containing offsets into the VVD.
+   * @param stripGroup VTX strip group to read vertex data from.
+   * @param iteratee Function to be called for each vertex, taking the VTX vertex, VVD vertex and tangent (in that order).
+   * @throws Errors::OutOfBoundsAccess A vertex points outside the VVD data.
+   */
+  void iterateVertices(
+    const Vvd& vvd,
+    const Mdl::Model& model,
+    const Mdl::Mesh& mesh,
+    const VtxView::StripGroup& stripGroup,
+    const std::function<void(const Structs::Vtx::Vertex &, const Structs::Vvd::Vertex &, const Structs::Vector4D &)>&
+    iteratee
+  );
+
+  /**
+   * Iterates over the vertex data for the given zero-copy strip group, calling iteratee with the VTX and VVD vertex data plus the tangent.
+   * @param vvd Parsed VVD containing per-vertex data.
+   * @param model Parsed model from the MDL containing offsets into the VVD.
+   * @param mesh Parsed mesh from the MDL containing offsets into the VVD.
+   * @param stripGroup VTX strip group to read vertex data from.
+   * @param lod Level of detail the strip group belongs to. With fixups, its VVD vertices are indexed with the model's
+   * and mesh's per-LoD offsets, as the engine does when that level is its root.
+   * @param iteratee Function to be called for each vertex, taking the VTX vertex, VVD vertex and tangent (in that order).
+   * @throws Errors::OutOfBoundsAccess The level of detail does not exist in the VVD, or a vertex points outside it.
+   */
+  void iterateVertices(
+    const Vvd& vvd,
+    const Mdl::Model& model,
+    const Mdl::Mesh& mesh,
+    const VtxView::StripGroup& stripGroup,
+    int lod,
+    const std::function<void(const Structs::Vtx::Vertex &, const Structs::Vvd::Vertex &, const Structs::Vector4D &)>&
+    iteratee
+  );
+
+  /**
+   * Iterates over the vertex data for the given zero-copy strip group, calling iteratee with the VTX and VVD vertex data plus the tangent.
+   * @remark VVD fixups are applied to each vertex as it is visited, so no vertex data is copied.
+   * @remark Uses the VVD vertices of the root level of detail.
+   * @param vvd Zero-copy VVD containing per-vertex data.
+   * @param model Parsed model from the MDL containing offsets into the VVD.
+   * @param mesh Parsed mesh from the MDL containing offsets into the VVD.
+   * @param stripGroup VTX strip group to read vertex data from.
+   * @param iteratee Function to be called for each vertex, taking the VTX vertex, VVD vertex and tangent (in that order).
+   * @throws Errors::OutOfBoundsAccess A vertex points outside the VVD data.
+   */
+  void iterateVertices(
+    const VvdView& vvd,
+    const Mdl::Model& model,
+    const Mdl::Mesh& mesh,
+    const VtxView::StripGroup& stripGroup,
+    const std::function<void(const Structs::Vtx::Vertex &, const Structs::Vvd::Vertex &, const Structs::Vector4D &)>&
+    iteratee
+  );
+
+  /**
+   * Iterates over the vertex data for the given zero-copy strip group, calling iteratee with the VTX and VVD vertex data plus the tangent.
+   * @remark VVD fixups are applied to each vertex as it is visited, so no vertex data is copied.
+   * @param vvd Zero-copy VVD containing per-vertex data.
+   * @param model Parsed model from the MDL containing offsets into the VVD.
+   * @param mesh Parsed mesh from the MDL containing offsets into the VVD.
+   * @param stripGroup VTX strip group to read vertex data from.
+   * @param lod Level of detail the strip group belongs to. With fixups, its VVD vertices are indexed with the model's
+   * and mesh's per-LoD offsets, as the engine does when that level is its root.
+   * @param iteratee Function to be called for each vertex, taking the VTX vertex, VVD vertex and tangent (in that order).
+   * @throws Errors::OutOfBoundsAccess A vertex points outside the VVD data.
+   */
+  void iterateVertices(
+    const VvdView& vvd,
+    const Mdl::Model& model,
+    const Mdl::Mesh& mesh,
+    const VtxView::StripGroup& stripGroup,
+    int lod,
+    const std::function<void(const Structs::Vtx::Vertex &, const Structs::Vvd::Vertex &, const Structs::Vector4D &)>&
+    iteratee
+  );
 }
@@ -0,0 +1,28 @@
+#include "vvd-indices.hpp"
+#include <source-parsers-shared/internal/check-bounds.hpp>
+
+namespace MdlParser {
+  using namespace SourceParsers::Internal;
+
+  VvdIndices getVvdIndices(
+    const Mdl::Model& model,
+    const Mdl::Mesh& mesh,
+    const int64_t meshVertex,
+    const int lod,
+    const bool hasFixups
+  ) {
+    checkBounds(lod, 1, Limits::MAX_NUM_LODS, "Level of detail is outside range");
+
+    // The root's fixed up arrays hold every vertex, so the MDL's own offsets still apply to them
+    if (!hasFixups || lod == 0) {
+      const int64_t meshOffset = mesh.vertexOffset;
+      return {
+        .vertex = model.vertexOffset + meshOffset + meshVertex,
+        .tangent = model.tangentsOffset + meshOffset + meshVertex,
+      };
+    }
+
+    const auto index = model.lodVertexOffsets[lod] + mesh.lodVertexOffsets[lod] + meshVertex;
+    return { .vertex = index, .tangent = index };
+  }
+}
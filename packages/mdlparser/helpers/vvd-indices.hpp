@@ -0,0 +1,30 @@
+#pragma once
+
+#include <cstdint>
+#include "../mdl.hpp"
+
+namespace MdlParser {
+  /**
+   * Position of a mesh vertex in a level of detail's VVD vertex and tangent arrays.
+   */
+  struct VvdIndices {
+    int64_t vertex;
+    int64_t tangent;
+  };
+
+  /**
+   * Finds a mesh vertex in a level of detail's VVD arrays. With fixups, each level's arrays only hold the vertices it
+   * uses, so the model's and mesh's per-LoD offsets are used. Without them every level shares the root's arrays, which
+   * the MDL's offsets index as is.
+   * @param meshVertex Index of the vertex within the mesh, as given by the VTX vertex's origMeshVertId.
+   * @param hasFixups Whether the VVD has a fixup table.
+   * @throws Errors::OutOfBoundsAccess The level of detail is outside range.
+   */
+  [[nodiscard]] VvdIndices getVvdIndices(
+    const Mdl::Model& model,
+    const Mdl::Mesh& mesh,
+    int64_t meshVertex,
+    int lod,
+    bool hasFixups
+  );
+}
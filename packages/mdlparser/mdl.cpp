@@ -7,6 +7,7 @@
 namespace MdlParser {
   using Structs::Mdl::Header;
   using Structs::Mdl::Header2;
+  using Limits::MAX_NUM_LODS;
   using namespace SourceParsers::Errors;
   using namespace SourceParsers::Internal;
 
@@ -18,6 +19,8 @@ namespace MdlParser {
         .material = mesh.material,
         .vertexOffset = mesh.vertsOffset,
         .vertexCount = mesh.vertsCount,
+        .lodVertexCounts = mesh.vertexdata.numLODVertexes,
+        .lodVertexOffsets = {},
       };
     }
 
@@ -38,6 +41,7 @@ namespace MdlParser {
         .vertexOffset = model.vertsOffset / static_cast<int32_t>(sizeof(Structs::Vvd::Vertex)),
         .tangentsOffset = model.tangentsOffset / static_cast<int32_t>(sizeof(Structs::Vector4D)),
         .vertexCount = model.vertsCount,
+        .lodVertexOffsets = {},
       };
     }
 
@@ -147,6 +151,26 @@ namespace MdlParser {
 
       return std::move(bones);
     }
+
+    /**
+     * Lays out every model and mesh in each level of detail's fixed up VVD arrays, in the order they appear in the MDL.
+     */
+    void setLodVertexOffsets(std::vector<Mdl::BodyPart>& bodyParts) {
+      std::array<int64_t, MAX_NUM_LODS> nextModelOffsets{};
+
+      for (auto& bodyPart : bodyParts) {
+        for (auto& model : bodyPart.models) {
+          model.lodVertexOffsets = nextModelOffsets;
+
+          for (auto& mesh : model.meshes) {
+            for (size_t lod = 0; lod < MAX_NUM_LODS; lod++) {
+              mesh.lodVertexOffsets[lod] = nextModelOffsets[lod] - model.lodVertexOffsets[lod];
+              nextModelOffsets[lod] += mesh.lodVertexCounts[lod];
+            }
+          }
+        }
+      }
+    }
   }
 
   Mdl::Mdl(const std::span<const std::byte> data, const std::optional<int32_t>& checksum) {
@@ -176,6 +200,8 @@ namespace MdlParser {
       bodyParts.push_back(parseBodyPart(dataView.withAbsoluteOffset(offset), bodyPart));
     }
 
+    setLodVertexOffsets(bodyParts);
+
     textureDirectories = parseTextureDirectories(dataView, header);
     textures = parseTextures(dataView, header);
     skins = parseSkinTable(dataView, header);
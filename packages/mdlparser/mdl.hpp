@@ -1,9 +1,11 @@
 #pragma once
 
+#include <array>
 #include <optional>
 #include <span>
 #include <string>
 #include <vector>
+#include "limits.hpp"
 #include "structs/mdl.hpp"
 
 namespace MdlParser {
@@ -34,6 +36,16 @@ namespace MdlParser {
        * Number of vertices and tangents in this mesh.
        */
       int32_t vertexCount;
+
+      /**
+       * Number of vertices and tangents in this mesh at each level of detail, once the VVD's fixups are applied.
+       */
+      std::array<int32_t, Limits::MAX_NUM_LODS> lodVertexCounts;
+
+      /**
+       * Offset to be added to the parent Model's lodVertexOffsets at each level of detail.
+       */
+      std::array<int64_t, Limits::MAX_NUM_LODS> lodVertexOffsets;
     };
 
     /**
@@ -59,6 +71,14 @@ namespace MdlParser {
        * Number of vertices and tangents in this model.
        */
       int32_t vertexCount;
+
+      /**
+       * Offset into the VVD's vertex and tangent arrays of each level of detail, once fixups are applied.
+       * @remark Each level's arrays leave out the vertices it doesn't use, so these differ from vertexOffset and
+       * @remark tangentsOffset whenever the VVD has fixups. They are rebuilt from every mesh's lodVertexCounts, as the
+       * @remark engine does when it sets a root level of detail.
+       */
+      std::array<int64_t, Limits::MAX_NUM_LODS> lodVertexOffsets;
     };
 
     /**
@@ -7,5 +7,10 @@ namespace MdlParser {}
 
 #include "accessors.hpp"
 #include "mdl.hpp"
+#include "model-cache.hpp"
+#include "model-mesh.hpp"
+#include "quantised-model-mesh.hpp"
+#include "vtx-view.hpp"
 #include "vtx.hpp"
+#include "vvd-view.hpp"
 #include "vvd.hpp"
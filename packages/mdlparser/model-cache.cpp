@@ -0,0 +1,24 @@
+#include "model-cache.hpp"
+#include <source-parsers-shared/errors.hpp>
+#include <source-parsers-shared/internal/offset-data-view.hpp>
+#include "structs/mdl.hpp"
+
+namespace MdlParser {
+  using namespace SourceParsers::Errors;
+  using namespace SourceParsers::Internal;
+
+  namespace {
+    constexpr auto FILE_ID = u'I' + (u'D' << 8u) + (u'S' << 16u) + (u'T' << 24u);
+  }
+
+  int32_t readMdlChecksum(const std::span<const std::byte> mdlData) {
+    const OffsetDataView dataView(mdlData);
+    const auto& header = dataView.parseStruct<Structs::Mdl::Header>(0, "Failed to parse MDL header");
+
+    if (header.id != FILE_ID) {
+      throw InvalidHeader("MDL header file ID does not match packed IDST");
+    }
+
+    return header.checksum;
+  }
+}
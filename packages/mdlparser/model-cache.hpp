@@ -0,0 +1,109 @@
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <span>
+#include <string_view>
+#include <vector>
+#include <source-parsers-shared/asset-cache.hpp>
+#include "mdl.hpp"
+#include "vtx.hpp"
+#include "vvd.hpp"
+
+namespace MdlParser {
+  /**
+   * Parsed MDL, VTX, VVD and PHY files of one model.
+   * @tparam Physics Type to parse the .phy file with, such as PhyParser::Phy, constructible from its data and the MDL's
+   * checksum.
+   */
+  template<typename Physics>
+  struct CachedModel {
+    Mdl mdl;
+    Vtx vtx;
+    Vvd vvd;
+    /**
+     * Parsed .phy file, or empty for models without collision.
+     */
+    std::optional<Physics> physics;
+    /**
+     * Total size of the files the model was parsed from, used as an estimate of its memory usage.
+     */
+    size_t sourceSize;
+  };
+
+  /**
+   * Contents of the files which accompany a .mdl file.
+   */
+  struct CompanionFiles {
+    std::vector<std::byte> vtx;
+    std::vector<std::byte> vvd;
+    /**
+     * Contents of the .phy file, or empty for models without collision.
+     */
+    std::optional<std::vector<std::byte>> phy;
+  };
+
+  /**
+   * Reads the checksum shared by the MDL, VTX and VVD from a .mdl file's header without parsing the rest of it.
+   * @param mdlData Contents of the .mdl file.
+   * @return The header's checksum.
+   * @throws Errors::OutOfBoundsAccess The data is too small to hold a header.
+   * @throws Errors::InvalidHeader The data is not an MDL file.
+   */
+  [[nodiscard]] int32_t readMdlChecksum(std::span<const std::byte> mdlData);
+
+  /**
+   * Thread-safe cache of parsed models keyed by path and checksum, so models shared by many maps, such as static props,
+   * are parsed once.
+   * Handles are shared and immutable, and the least recently used models are evicted once the total size of the files
+   * they were parsed from exceeds the memory budget.
+   * @tparam Physics Type to parse .phy files with, such as PhyParser::Phy, constructible from the file's data and
+   * the MDL's checksum.
+   */
+  template<typename Physics>
+  class ModelCache : public SourceParsers::AssetCache<CachedModel<Physics>> {
+  public:
+    /**
+     * @param memoryBudget Most bytes of source files to keep cached models within.
+     */
+    explicit ModelCache(const size_t memoryBudget) :
+      SourceParsers::AssetCache<CachedModel<Physics>>(
+        memoryBudget,
+        [](const CachedModel<Physics>& model) { return model.sourceSize; }
+      ) {}
+
+    /**
+     * Returns the cached model for path and the checksum in mdlData's header, parsing it on a miss.
+     * @param path Path of the .mdl file, compared exactly.
+     * @param mdlData Contents of the .mdl file.
+     * @param readCompanionFiles Reads the model's VTX, VVD and PHY files. Only called on a miss.
+     * @return Shared, immutable model.
+     * @throws Errors::InvalidChecksum The VTX, VVD or PHY were not compiled with the MDL.
+     * @remark Any other error from parsing the files is thrown as is, and nothing is cached.
+     */
+    [[nodiscard]] std::shared_ptr<const CachedModel<Physics>> getOrParse(
+      const std::string_view path,
+      const std::span<const std::byte> mdlData,
+      const std::function<CompanionFiles()>& readCompanionFiles
+    ) {
+      return this->getOrLoad(path, readMdlChecksum(mdlData), [&]() {
+        const auto files = readCompanionFiles();
+        Mdl mdl(mdlData);
+        const auto checksum = mdl.getChecksum();
+
+        return CachedModel<Physics>{
+          .mdl = std::move(mdl),
+          .vtx = Vtx(files.vtx, checksum),
+          .vvd = Vvd(files.vvd, checksum),
+          .physics = files.phy.has_value()
+            ? std::optional<Physics>(std::in_place, std::span<const std::byte>(files.phy.value()), checksum)
+            : std::nullopt,
+          .sourceSize = mdlData.size_bytes() + files.vtx.size() + files.vvd.size() +
+          (files.phy.has_value() ? files.phy->size() : 0),
+        };
+      });
+    }
+  };
+}
@@ -0,0 +1,354 @@
+#include "model-mesh.hpp"
+#include <source-parsers-shared/errors.hpp>
+#include <source-parsers-shared/internal/check-bounds.hpp>
+#include "helpers/vvd-indices.hpp"
+
+namespace MdlParser {
+  using namespace SourceParsers::Errors;
+  using namespace SourceParsers::Internal;
+  using Enums::Vtx::StripFlags;
+
+  static_assert(sizeof(ModelVertex) == 64, "ModelVertex should fill exactly one cache line");
+
+  namespace {
+    /**
+     * Calls iteratee with every MDL mesh, and the VTX mesh of the chosen level of detail, in the chosen body groups.
+     */
+    template<typename VtxType, typename Iteratee>
+    void iterateSelectedMeshes(
+      const Mdl& mdl,
+      const VtxType& vtx,
+      const ModelMeshOptions& options,
+      const Iteratee& iteratee
+    ) {
+      const auto& mdlBodyParts = mdl.getBodyParts();
+      const std::span vtxBodyParts(vtx.getBodyParts());
+
+      if (mdlBodyParts.size() != vtxBodyParts.size()) {
+        throw OutOfBoundsAccess("MDL and VTX body part counts do not match");
+      }
+
+      for (size_t bodyPart = 0; bodyPart < mdlBodyParts.size(); bodyPart++) {
+        const auto& mdlModels = mdlBodyParts[bodyPart].models;
+        const std::span vtxModels(vtxBodyParts[bodyPart].models);
+
+        if (mdlModels.size() != vtxModels.size()) {
+          throw OutOfBoundsAccess("MDL and VTX model counts do not match");
+        }
+        if (mdlModels.empty()) {
+          continue;
+        }
+
+        const auto model = bodyPart < options.bodyGroups.size() ? options.bodyGroups[bodyPart] : 0;
+        checkBounds(model, 1, mdlModels.size(), "Body group model is outside range");
+
+        const auto& mdlModel = mdlModels[model];
+        const std::span vtxLods(vtxModels[model].levelOfDetails);
+        checkBounds(options.lod, 1, vtxLods.size(), "Level of detail is outside range");
+
+        const std::span vtxMeshes(vtxLods[options.lod].meshes);
+        if (mdlModel.meshes.size() != vtxMeshes.size()) {
+          throw OutOfBoundsAccess("MDL and VTX mesh counts do not match");
+        }
+
+        for (size_t mesh = 0; mesh < vtxMeshes.size(); mesh++) {
+          iteratee(mdlModel, mdlModel.meshes[mesh], vtxMeshes[mesh]);
+        }
+      }
+    }
+
+    /**
+     * Calls iteratee with each triangle of a strip, as indices into the strip group's vertices.
+     * @remark Strips were bounds checked against their strip group when the VTX was parsed, but their index values were
+     * @remark not.
+     * @throws Errors::OutOfBoundsAccess An index lies outside the strip group's vertices.
+     */
+    template<typename Iteratee>
+    void iterateStripTriangles(
+      const std::span<const uint16_t> stripGroupIndices,
+      const size_t stripGroupVertexCount,
+      const Vtx::Strip& strip,
+      const Iteratee& iteratee
+    ) {
+      const auto indices = stripGroupIndices.subspan(strip.indicesOffset, strip.indicesCount);
+      for (const auto index : indices) {
+        checkBounds(index, 1, stripGroupVertexCount, "Strip index is outside strip group vertices");
+      }
+
+      if ((strip.flags & StripFlags::IS_TRISTRIP) == StripFlags::NONE) {
+        for (size_t i = 0; i + 3 <= indices.size(); i += 3) {
+          iteratee(indices[i], indices[i + 1], indices[i + 2]);
+        }
+
+        return;
+      }
+
+      for (size_t i = 0; i + 3 <= indices.size(); i++) {
+        // Every other triangle in a strip is wound the other way, and strips are stitched with degenerate triangles
+        const auto i0 = indices[i + (i & 1)];
+        const auto i1 = indices[i + 1 - (i & 1)];
+        const auto i2 = indices[i + 2];
+
+        if (i0 != i1 && i1 != i2 && i0 != i2) {
+          iteratee(i0, i1, i2);
+        }
+      }
+    }
+
+    std::vector<SourceParsers::MeshOptimisation::IndexRange> getIndexRanges(
+      const std::span<const ModelDrawRange> drawRanges
+    ) {
+      std::vector<SourceParsers::MeshOptimisation::IndexRange> ranges;
+      ranges.reserve(drawRanges.size());
+      for (const auto& drawRange : drawRanges) {
+        ranges.push_back({ .firstIndex = drawRange.firstIndex, .indexCount = drawRange.indexCount });
+      }
+
+      return ranges;
+    }
+
+    int16_t getMaterial(const Mdl& mdl, const Mdl::Mesh& mesh, const int skin) {
+      const auto& skins = mdl.getSkinLookupTable();
+      checkBounds(skin, 1, skins.size(), "Skin is outside range");
+      checkBounds(mesh.material, 1, skins[skin].size(), "Mesh material is outside skin lookup table");
+
+      return skins[skin][mesh.material];
+    }
+
+    template<typename VtxType>
+    ModelMeshSize getSize(const Mdl& mdl, const VtxType& vtx, const ModelMeshOptions& options) {
+      ModelMeshSize size{ .vertexCount = 0, .indexCount = 0, .drawRangeCount = 0 };
+
+      iterateSelectedMeshes(
+        mdl,
+        vtx,
+        options,
+        [&](const Mdl::Model&, const Mdl::Mesh& mdlMesh, const auto& vtxMesh) {
+          (void) getMaterial(mdl, mdlMesh, options.skin);
+          size_t meshIndexCount = 0;
+
+          for (const auto& stripGroup : vtxMesh.stripGroups) {
+            size.vertexCount += stripGroup.vertices.size();
+
+            for (const auto& strip : stripGroup.strips) {
+              iterateStripTriangles(
+                stripGroup.indices,
+                stripGroup.vertices.size(),
+                strip,
+                [&](uint16_t, uint16_t, uint16_t) { meshIndexCount += 3; }
+              );
+            }
+          }
+
+          size.indexCount += meshIndexCount;
+          size.drawRangeCount += meshIndexCount > 0;
+        }
+      );
+
+      if (size.vertexCount > UINT32_MAX || size.indexCount > UINT32_MAX) {
+        throw OutOfBoundsAccess("Model mesh is too large for 32 bit indices");
+      }
+
+      return size;
+    }
+
+    const Structs::Vvd::Vertex& getVvdVertex(const Vvd& vvd, const int64_t index, const int lod) {
+      const auto& vertices = vvd.getVertices(lod);
+      checkBounds(index, 1, vertices.size(), "VVD vertex index is outside range");
+
+      return vertices[index];
+    }
+
+    const Structs::Vector4D& getVvdTangent(const Vvd& vvd, const int64_t index, const int lod) {
+      const auto& tangents = vvd.getTangents(lod);
+      checkBounds(index, 1, tangents.size(), "VVD vertex index is outside range");
+
+      return tangents[index];
+    }
+
+    const Structs::Vvd::Vertex& getVvdVertex(const VvdView& vvd, const int64_t index, const int lod) {
+      return vvd.getVertex(index, lod);
+    }
+
+    const Structs::Vector4D& getVvdTangent(const VvdView& vvd, const int64_t index, const int lod) {
+      return vvd.getTangent(index, lod);
+    }
+
+    /**
+     * Writes the mesh into buffers already known to be large enough.
+     */
+    template<typename VtxType, typename VvdType>
+    void fill(
+      const Mdl& mdl,
+      const VtxType& vtx,
+      const VvdType& vvd,
+      const std::span<ModelVertex> vertices,
+      const std::span<uint32_t> indices,
+      const std::span<ModelDrawRange> drawRanges,
+      const ModelMeshOptions& options
+    ) {
+      auto nextVertex = vertices.begin();
+      auto nextIndex = indices.begin();
+      auto nextDrawRange = drawRanges.begin();
+
+      iterateSelectedMeshes(
+        mdl,
+        vtx,
+        options,
+        [&](const Mdl::Model& mdlModel, const Mdl::Mesh& mdlMesh, const auto& vtxMesh) {
+          const auto firstIndex = static_cast<uint32_t>(nextIndex - indices.begin());
+
+          for (const auto& stripGroup : vtxMesh.stripGroups) {
+            const auto baseVertex = static_cast<uint32_t>(nextVertex - vertices.begin());
+
+            for (const auto& vtxVertex : stripGroup.vertices) {
+              const auto [vertexIndex, tangentIndex] =
+                getVvdIndices(mdlModel, mdlMesh, vtxVertex.origMeshVertId, options.lod, vvd.hasFixups());
+              const auto& vvdVertex = getVvdVertex(vvd, vertexIndex, options.lod);
+              const auto& boneWeights = vvdVertex.boneWeights;
+
+              *nextVertex++ = {
+                .position = vvdVertex.pos,
+                .normal = vvdVertex.normal,
+                .tangent = getVvdTangent(vvd, tangentIndex, options.lod),
+                .uv = vvdVertex.texCoord,
+                .boneWeights = boneWeights.weight,
+                .boneIndices = {
+                  static_cast<uint8_t>(boneWeights.bone[0]),
+                  static_cast<uint8_t>(boneWeights.bone[1]),
+                  static_cast<uint8_t>(boneWeights.bone[2]),
+                },
+                .boneCount = boneWeights.numBones,
+              };
+            }
+
+            for (const auto& strip : stripGroup.strips) {
+              iterateStripTriangles(
+                stripGroup.indices,
+                stripGroup.vertices.size(),
+                strip,
+                [&](const uint16_t i0, const uint16_t i1, const uint16_t i2) {
+                  *nextIndex++ = baseVertex + i0;
+                  *nextIndex++ = baseVertex + i1;
+                  *nextIndex++ = baseVertex + i2;
+                }
+              );
+            }
+          }
+
+          const auto indexCount = static_cast<uint32_t>(nextIndex - indices.begin()) - firstIndex;
+          if (indexCount > 0) {
+            *nextDrawRange++ = {
+              .material = getMaterial(mdl, mdlMesh, options.skin),
+              .firstIndex = firstIndex,
+              .indexCount = indexCount,
+            };
+          }
+        }
+      );
+
+      if (options.optimisation.has_value()) {
+        const auto ranges = getIndexRanges(drawRanges.first(nextDrawRange - drawRanges.begin()));
+
+        SourceParsers::MeshOptimisation::optimiseMesh(
+          indices.first(nextIndex - indices.begin()),
+          std::span<const SourceParsers::MeshOptimisation::IndexRange>(ranges),
+          vertices.first(nextVertex - vertices.begin()),
+          options.optimisation.value()
+        );
+      }
+    }
+
+    template<typename VtxType, typename VvdType>
+    ModelMeshSize write(
+      const Mdl& mdl,
+      const VtxType& vtx,
+      const VvdType& vvd,
+      const std::span<ModelVertex> vertices,
+      const std::span<uint32_t> indices,
+      const std::span<ModelDrawRange> drawRanges,
+      const ModelMeshOptions& options
+    ) {
+      const auto size = getSize(mdl, vtx, options);
+      if (
+        vertices.size() < size.vertexCount ||
+        indices.size() < size.indexCount ||
+        drawRanges.size() < size.drawRangeCount
+      ) {
+        throw BufferTooSmall("Buffers are too small to hold the model mesh");
+      }
+
+      fill(mdl, vtx, vvd, vertices, indices, drawRanges, options);
+
+      return size;
+    }
+
+    template<typename VtxType, typename VvdType>
+    ModelMesh build(const Mdl& mdl, const VtxType& vtx, const VvdType& vvd, const ModelMeshOptions& options) {
+      const auto size = getSize(mdl, vtx, options);
+
+      ModelMesh mesh{
+        .vertices = std::vector<ModelVertex>(size.vertexCount),
+        .indices = std::vector<uint32_t>(size.indexCount),
+        .drawRanges = std::vector<ModelDrawRange>(size.drawRangeCount),
+      };
+      fill(mdl, vtx, vvd, std::span(mesh.vertices), std::span(mesh.indices), std::span(mesh.drawRanges), options);
+
+      return mesh;
+    }
+  }
+
+  ModelMeshSize getModelMeshSize(const Mdl& mdl, const VtxView& vtx, const ModelMeshOptions& options) {
+    return getSize(mdl, vtx, options);
+  }
+
+  ModelMeshSize getModelMeshSize(const Mdl& mdl, const Vtx& vtx, const ModelMeshOptions& options) {
+    return getSize(mdl, vtx, options);
+  }
+
+  ModelMeshSize writeModelMesh(
+    const Mdl& mdl,
+    const VtxView& vtx,
+    const VvdView& vvd,
+    const std::span<ModelVertex> vertices,
+    const std::span<uint32_t> indices,
+    const std::span<ModelDrawRange> drawRanges,
+    const ModelMeshOptions& options
+  ) {
+    return write(mdl, vtx, vvd, vertices, indices, drawRanges, options);
+  }
+
+  ModelMeshSize writeModelMesh(
+    const Mdl& mdl,
+    const Vtx& vtx,
+    const Vvd& vvd,
+    const std::span<ModelVertex> vertices,
+    const std::span<uint32_t> indices,
+    const std::span<ModelDrawRange> drawRanges,
+    const ModelMeshOptions& options
+  ) {
+    return write(mdl, vtx, vvd, vertices, indices, drawRanges, options);
+  }
+
+  ModelMesh buildModelMesh(const Mdl& mdl, const VtxView& vtx, const VvdView& vvd, const ModelMeshOptions& options) {
+    return build(mdl, vtx, vvd, options);
+  }
+
+  ModelMesh buildModelMesh(const Mdl& mdl, const Vtx& vtx, const Vvd& vvd, const ModelMeshOptions& options) {
+    return build(mdl, vtx, vvd, options);
+  }
+
+  SourceParsers::Meshlets::MeshletBuffer buildModelMeshlets(
+    const ModelMesh& mesh,
+    const SourceParsers::Meshlets::Options& options
+  ) {
+    const auto ranges = getIndexRanges(mesh.drawRanges);
+
+    return SourceParsers::Meshlets::buildMeshlets(
+      std::span<const uint32_t>(mesh.indices),
+      std::span<const SourceParsers::MeshOptimisation::IndexRange>(ranges),
+      std::span<const ModelVertex>(mesh.vertices),
+      options
+    );
+  }
+}
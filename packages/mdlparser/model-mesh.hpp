@@ -0,0 +1,192 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <vector>
+#include <source-parsers-shared/mesh-optimisation.hpp>
+#include <source-parsers-shared/meshlets.hpp>
+#include "limits.hpp"
+#include "mdl.hpp"
+#include "structs/common.hpp"
+#include "vtx-view.hpp"
+#include "vtx.hpp"
+#include "vvd-view.hpp"
+#include "vvd.hpp"
+
+namespace MdlParser {
+  /**
+   * Interleaved vertex of a merged model mesh, laid out to be uploaded to the GPU as is.
+   */
+  struct ModelVertex {
+    Structs::Vector position;
+    Structs::Vector normal;
+    Structs::Vector4D tangent;
+    Structs::Vector2D uv;
+
+    std::array<float, Limits::MAX_NUM_BONES_PER_VERT> boneWeights;
+    /**
+     * Indices into Mdl::getBones() of the bones weighted by boneWeights.
+     */
+    std::array<uint8_t, Limits::MAX_NUM_BONES_PER_VERT> boneIndices;
+    uint8_t boneCount;
+  };
+
+  /**
+   * A range of the index buffer drawn with a single material.
+   */
+  struct ModelDrawRange {
+    /**
+     * Index into Mdl::getTextures(), with the skin already applied.
+     */
+    int16_t material;
+    uint32_t firstIndex;
+    uint32_t indexCount;
+  };
+
+  /**
+   * Which combination of the model's body groups, skins and levels of detail to build a mesh for.
+   */
+  struct ModelMeshOptions {
+    /**
+     * Index of the model to use from each body part. Body parts past the end use their first model.
+     */
+    std::span<const int> bodyGroups;
+    /**
+     * Row of the skin lookup table (skin family) used to pick each mesh's material.
+     */
+    int skin = 0;
+    int lod = 0;
+    /**
+     * Passes to reorder the mesh with for faster rendering once it is built, or none to keep the VTX order.
+     * @remark Triangles are only reordered within their draw range, and vertices across the whole vertex buffer.
+     */
+    std::optional<SourceParsers::MeshOptimisation::Options> optimisation;
+  };
+
+  /**
+   * Exact number of elements a merged model mesh is built from.
+   */
+  struct ModelMeshSize {
+    size_t vertexCount;
+    size_t indexCount;
+    size_t drawRangeCount;
+  };
+
+  /**
+   * A whole model merged into one vertex buffer and one triangle list index buffer.
+   */
+  struct ModelMesh {
+    std::vector<ModelVertex> vertices;
+    /**
+     * Triangle list indices into vertices, in the model's clockwise winding.
+     */
+    std::vector<uint32_t> indices;
+    /**
+     * One range for each MDL mesh with any triangles, in body part, model and mesh order.
+     */
+    std::vector<ModelDrawRange> drawRanges;
+  };
+
+  /**
+   * Computes the exact size of the merged mesh for a combination of body groups, skin and level of detail, without
+   * building it.
+   * @param mdl Parsed MDL.
+   * @param vtx Parsed VTX.
+   * @param options Combination to build.
+   * @return Number of vertices, indices and draw ranges.
+   * @throws Errors::OutOfBoundsAccess A body group, skin, material or level of detail does not exist, the MDL and VTX
+   * do not have the same structure, or a strip index lies outside its strip group.
+   */
+  [[nodiscard]] ModelMeshSize getModelMeshSize(
+    const Mdl& mdl,
+    const VtxView& vtx,
+    const ModelMeshOptions& options = {}
+  );
+
+  /**
+   * Same as the overload taking a VtxView and VvdView, for a Vtx and Vvd parsed in copying mode.
+   */
+  [[nodiscard]] ModelMeshSize getModelMeshSize(const Mdl& mdl, const Vtx& vtx, const ModelMeshOptions& options = {});
+
+  /**
+   * Builds the merged mesh for a combination of body groups, skin and level of detail into caller-provided buffers,
+   * such as mapped GPU memory.
+   * @remark Triangle strips are converted to triangle lists, dropping degenerate triangles.
+   * @param mdl Parsed MDL.
+   * @param vtx Parsed VTX.
+   * @param vvd Parsed VVD, whose vertices for the chosen level of detail are used.
+   * @param vertices Destination for getModelMeshSize().vertexCount vertices.
+   * @param indices Destination for getModelMeshSize().indexCount indices.
+   * @param drawRanges Destination for getModelMeshSize().drawRangeCount draw ranges.
+   * @param options Combination to build.
+   * @return Number of vertices, indices and draw ranges written.
+   * @throws Errors::OutOfBoundsAccess A body group, skin, material or level of detail does not exist, the MDL and VTX
+   * do not have the same structure, a strip index lies outside its strip group, or a vertex lies outside the VVD.
+   * @throws Errors::BufferTooSmall Any of the buffers cannot hold the output.
+   */
+  ModelMeshSize writeModelMesh(
+    const Mdl& mdl,
+    const VtxView& vtx,
+    const VvdView& vvd,
+    std::span<ModelVertex> vertices,
+    std::span<uint32_t> indices,
+    std::span<ModelDrawRange> drawRanges,
+    const ModelMeshOptions& options = {}
+  );
+
+  /**
+   * Same as the overload taking a VtxView and VvdView, for a Vtx and Vvd parsed in copying mode.
+   */
+  ModelMeshSize writeModelMesh(
+    const Mdl& mdl,
+    const Vtx& vtx,
+    const Vvd& vvd,
+    std::span<ModelVertex> vertices,
+    std::span<uint32_t> indices,
+    std::span<ModelDrawRange> drawRanges,
+    const ModelMeshOptions& options = {}
+  );
+
+  /**
+   * Builds the merged mesh for a combination of body groups, skin and level of detail into new buffers, each allocated
+   * once at its final size.
+   * @param mdl Parsed MDL.
+   * @param vtx Parsed VTX.
+   * @param vvd Parsed VVD, whose vertices for the chosen level of detail are used.
+   * @param options Combination to build.
+   * @return The merged mesh.
+   * @throws Errors::OutOfBoundsAccess A body group, skin, material or level of detail does not exist, the MDL and VTX
+   * do not have the same structure, a strip index lies outside its strip group, or a vertex lies outside the VVD.
+   */
+  [[nodiscard]] ModelMesh buildModelMesh(
+    const Mdl& mdl,
+    const VtxView& vtx,
+    const VvdView& vvd,
+    const ModelMeshOptions& options = {}
+  );
+
+  /**
+   * Same as the overload taking a VtxView and VvdView, for a Vtx and Vvd parsed in copying mode.
+   */
+  [[nodiscard]] ModelMesh buildModelMesh(
+    const Mdl& mdl,
+    const Vtx& vtx,
+    const Vvd& vvd,
+    const ModelMeshOptions& options = {}
+  );
+
+  /**
+   * Splits a merged model mesh into meshlets for mesh shaders, never letting one span two draw ranges so every meshlet
+   * has a single material.
+   * @param mesh Mesh from buildModelMesh.
+   * @param options Meshlet size limits.
+   * @return The packed meshlets, with one range for each of mesh.drawRanges.
+   * @throws Errors::InvalidOptions The options allow fewer than 3 vertices or 1 triangle, or more than 256 vertices.
+   */
+  [[nodiscard]] SourceParsers::Meshlets::MeshletBuffer buildModelMeshlets(
+    const ModelMesh& mesh,
+    const SourceParsers::Meshlets::Options& options = {}
+  );
+}
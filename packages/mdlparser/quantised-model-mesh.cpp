@@ -0,0 +1,74 @@
+#include "quantised-model-mesh.hpp"
+#include <algorithm>
+#include <cmath>
+
+namespace MdlParser {
+  namespace {
+    std::optional<uint8_t> getRigidBone(const std::span<const ModelVertex> vertices) {
+      if (vertices.empty()) {
+        return std::nullopt;
+      }
+
+      const auto bone = vertices.front().boneIndices[0];
+      const auto isRigid = std::ranges::all_of(vertices, [bone](const ModelVertex& vertex) {
+        return vertex.boneCount == 1 && vertex.boneIndices[0] == bone;
+      });
+
+      return isRigid ? std::optional(bone) : std::nullopt;
+    }
+
+    QuantisedBoneWeights quantiseBoneWeights(const ModelVertex& vertex) {
+      QuantisedBoneWeights quantised{ .boneIndices = { 0, 0, 0, 0 }, .weights = { 0, 0, 0, 0 } };
+      const auto boneCount = std::min<size_t>(vertex.boneCount, vertex.boneWeights.size());
+      if (boneCount == 0) {
+        return quantised;
+      }
+
+      float total = 0;
+      for (size_t bone = 0; bone < boneCount; bone++) {
+        total += std::max(vertex.boneWeights[bone], 0.f);
+      }
+
+      // Round every weight down, then hand what is left of 255 to the largest so they still sum exactly
+      int remaining = 255;
+      size_t largest = 0;
+      for (size_t bone = 0; bone < boneCount; bone++) {
+        const auto weight = total > 0 ? std::max(vertex.boneWeights[bone], 0.f) / total : 1.f / boneCount;
+
+        quantised.boneIndices[bone] = vertex.boneIndices[bone];
+        quantised.weights[bone] = static_cast<uint8_t>(std::floor(weight * 255.f));
+        remaining -= quantised.weights[bone];
+
+        if (vertex.boneWeights[bone] > vertex.boneWeights[largest]) {
+          largest = bone;
+        }
+      }
+      quantised.weights[largest] = static_cast<uint8_t>(quantised.weights[largest] + remaining);
+
+      return quantised;
+    }
+  }
+
+  QuantisedModelVertices quantiseModelVertices(
+    const std::span<const ModelVertex> vertices,
+    const ModelQuantisationOptions& options
+  ) {
+    auto buffer = SourceParsers::VertexQuantisation::quantiseVertexBuffer(vertices, options.bounds);
+    QuantisedModelVertices quantised{
+      .bounds = buffer.bounds,
+      .vertices = std::move(buffer.vertices),
+      .boneWeights = {},
+      .rigidBone = options.dropRigidBoneWeights ? getRigidBone(vertices) : std::nullopt,
+    };
+
+    if (!quantised.rigidBone.has_value()) {
+      quantised.boneWeights.reserve(vertices.size());
+
+      for (const auto& vertex : vertices) {
+        quantised.boneWeights.push_back(quantiseBoneWeights(vertex));
+      }
+    }
+
+    return quantised;
+  }
+}
@@ -0,0 +1,67 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <vector>
+#include <source-parsers-shared/vertex-quantisation.hpp>
+#include "model-mesh.hpp"
+
+namespace MdlParser {
+  /**
+   * Skinning data of a quantised vertex, kept apart from QuantisedVertex so rigid meshes can drop it.
+   */
+  struct QuantisedBoneWeights {
+    /**
+     * Indices into Mdl::getBones(), with unused slots set to 0.
+     */
+    std::array<uint8_t, 4> boneIndices;
+    /**
+     * Weights as 8 bit unsigned normalised values which add up to exactly 255, with unused slots set to 0.
+     */
+    std::array<uint8_t, 4> weights;
+  };
+
+  /**
+   * How to quantise the vertices of a merged model mesh.
+   */
+  struct ModelQuantisationOptions {
+    /**
+     * Bounds to quantise positions relative to, or empty to use the vertices' own bounds.
+     */
+    std::optional<SourceParsers::VertexQuantisation::PositionBounds> bounds;
+    /**
+     * Whether to drop the bone weights when every vertex is weighted entirely to the same bone, as with most static
+     * props.
+     */
+    bool dropRigidBoneWeights = true;
+  };
+
+  /**
+   * Vertices of a merged model mesh, quantised for upload to the GPU. The mesh's indices and draw ranges still apply.
+   */
+  struct QuantisedModelVertices {
+    SourceParsers::VertexQuantisation::PositionBounds bounds;
+    std::vector<SourceParsers::VertexQuantisation::QuantisedVertex> vertices;
+    /**
+     * Bone weights of each vertex, or empty if they were dropped.
+     */
+    std::vector<QuantisedBoneWeights> boneWeights;
+    /**
+     * The bone every vertex is weighted to, if the bone weights were dropped.
+     */
+    std::optional<uint8_t> rigidBone;
+  };
+
+  /**
+   * Quantises the vertices of a merged model mesh, shrinking each from 64 bytes to 20, plus 8 if it needs bone weights.
+   * @param vertices Vertices of a ModelMesh.
+   * @param options How to quantise them.
+   * @return The quantised vertices, in the same order.
+   */
+  [[nodiscard]] QuantisedModelVertices quantiseModelVertices(
+    std::span<const ModelVertex> vertices,
+    const ModelQuantisationOptions& options = {}
+  );
+}
@@ -104,7 +104,7 @@ namespace MdlParser::Structs::Mdl {
 
     Vector centre;
 
-    // Unused, only for alignment
+    // Only numLODVertexes is used, which gives the mesh's vertex count in each level of detail's fixed up vertices
     mstudio_meshvertexdata_t vertexdata;
 
     std::array<int32_t, 8> unused;
@@ -0,0 +1,307 @@
+#include "vtx-view.hpp"
+#include <cstdint>
+#include <optional>
+#include <source-parsers-shared/errors.hpp>
+#include <source-parsers-shared/internal/offset-data-view.hpp>
+
+namespace MdlParser {
+  using Structs::Vtx::Header;
+  using namespace SourceParsers::Errors;
+  using namespace SourceParsers::Internal;
+
+  namespace {
+    /**
+     * Array of raw structs for each element of a level of the tree, in the same order as the level above.
+     */
+    template<typename T>
+    using RawArrays = std::vector<std::span<const T>>;
+
+    size_t getCount(const int32_t count, const char* errorMessage) {
+      if (count < 0) {
+        throw OutOfBoundsAccess(errorMessage);
+      }
+
+      return count;
+    }
+
+    /**
+     * Location of a parent's child array, as stored in the parent.
+     */
+    struct ChildArray {
+      /**
+       * Offset of the first child relative to the parent.
+       */
+      int32_t offset;
+      int32_t count;
+    };
+
+    template<typename T>
+    size_t getTotalSize(const RawArrays<T>& arrays) {
+      size_t total = 0;
+      for (const auto& array : arrays) {
+        total += array.size();
+      }
+
+      return total;
+    }
+
+    template<typename T>
+    size_t getOffset(const std::span<const std::byte> data, const T& element) {
+      return reinterpret_cast<const std::byte*>(&element) - data.data();
+    }
+
+    /**
+     * Parses the child array of every element in one level of the tree, in order.
+     * @param data Whole VTX buffer.
+     * @param parentArrays Raw structs of the level above.
+     * @param getChildren Gets the ChildArray stored in a parent.
+     * @param errorMessage Message to throw if any array lies outside the buffer.
+     * @return One array per parent, each viewing data.
+     */
+    template<typename Child, typename Parent, typename GetChildren>
+    RawArrays<Child> parseChildArrays(
+      const std::span<const std::byte> data,
+      const RawArrays<Parent>& parentArrays,
+      const GetChildren& getChildren,
+      const char* errorMessage
+    ) {
+      const OffsetDataView dataView(data);
+      RawArrays<Child> childArrays;
+      childArrays.reserve(getTotalSize(parentArrays));
+
+      for (const auto& parents : parentArrays) {
+        for (const auto& parent : parents) {
+          const ChildArray children = getChildren(parent);
+          childArrays.push_back(
+            dataView.withAbsoluteOffset(getOffset(data, parent)).template parseStructArray<Child>(
+              children.offset,
+              getCount(children.count, errorMessage),
+              errorMessage
+            )
+          );
+        }
+      }
+
+      return childArrays;
+    }
+
+    /**
+     * Gets the next run of an already built level, for its parent in the level above.
+     * @remark The level must not grow after this is called, as it would invalidate the run.
+     */
+    template<typename T>
+    std::span<const T> takeChildren(const std::vector<T>& level, size_t& next, const size_t count) {
+      const std::span<const T> children(level.data() + next, count);
+      next += count;
+
+      return children;
+    }
+  }
+
+  VtxView::VtxView(const std::span<const std::byte> data, const std::optional<int32_t>& checksum) {
+    const OffsetDataView dataView(data);
+    header = dataView.parseStruct<Header>(0, "Failed to parse VTX header");
+
+    if (header.version != Header::SUPPORTED_VERSION) {
+      throw UnsupportedVersion("VTX version is unsupported");
+    }
+    if (checksum.has_value() && header.checksum != checksum.value()) {
+      throw InvalidChecksum("VTX checksum does not match");
+    }
+
+    // Walk down the tree one level at a time, validating every array before anything is built
+    const RawArrays<Structs::Vtx::BodyPart> rawBodyParts{
+      dataView.parseStructArray<Structs::Vtx::BodyPart>(
+        header.bodyPartOffset,
+        getCount(header.numBodyParts, "Failed to parse VTX body part array"),
+        "Failed to parse VTX body part array"
+      ),
+    };
+    const auto rawModels = parseChildArrays<Structs::Vtx::Model>(
+      data,
+      rawBodyParts,
+      [](const Structs::Vtx::BodyPart& bodyPart) {
+        return ChildArray{ .offset = bodyPart.modelOffset, .count = bodyPart.numModels };
+      },
+      "Failed to parse VTX model array"
+    );
+    for (const auto& modelArray : rawModels) {
+      for (const auto& model : modelArray) {
+        if (model.numLoDs != header.numLoDs) {
+          throw InvalidBody("VTX model LoD count does not match header");
+        }
+      }
+    }
+    const auto rawLods = parseChildArrays<Structs::Vtx::ModelLoD>(
+      data,
+      rawModels,
+      [](const Structs::Vtx::Model& model) {
+        return ChildArray{ .offset = model.lodOffset, .count = model.numLoDs };
+      },
+      "Failed to parse VTX model LoD array"
+    );
+    const auto rawMeshes = parseChildArrays<Structs::Vtx::Mesh>(
+      data,
+      rawLods,
+      [](const Structs::Vtx::ModelLoD& lod) {
+        return ChildArray{ .offset = lod.meshOffset, .count = lod.numMeshes };
+      },
+      "Failed to parse VTX mesh array"
+    );
+    const auto rawStripGroups = parseChildArrays<Structs::Vtx::StripGroup>(
+      data,
+      rawMeshes,
+      [](const Structs::Vtx::Mesh& mesh) {
+        return ChildArray{ .offset = mesh.stripGroupHeaderOffset, .count = mesh.numStripGroups };
+      },
+      "Failed to parse VTX strip group array"
+    );
+    const auto rawStrips = parseChildArrays<Structs::Vtx::Strip>(
+      data,
+      rawStripGroups,
+      [](const Structs::Vtx::StripGroup& stripGroup) {
+        return ChildArray{ .offset = stripGroup.stripOffset, .count = stripGroup.numStrips };
+      },
+      "Failed to parse VTX strip array"
+    );
+
+    // Then build it back up from the leaves, with every level reserved up front so the runs handed out stay valid
+    strips.reserve(getTotalSize(rawStrips));
+    stripGroups.reserve(rawStrips.size());
+    auto stripArray = rawStrips.begin();
+    for (const auto& stripGroupArray : rawStripGroups) {
+      for (const auto& stripGroup : stripGroupArray) {
+        const auto firstStrip = strips.size();
+
+        for (const auto& strip : *stripArray++) {
+          checkBounds(
+            strip.vertOffset,
+            strip.numVerts,
+            stripGroup.numVerts,
+            "VTX strip accesses outside strip group vertex data"
+          );
+          checkBounds(
+            strip.indexOffset,
+            strip.numIndices,
+            stripGroup.numIndices,
+            "VTX strip accesses outside strip group index data"
+          );
+
+          strips.push_back(
+            {
+              .verticesCount = strip.numVerts,
+              .verticesOffset = strip.vertOffset,
+              .indicesCount = strip.numIndices,
+              .indicesOffset = strip.indexOffset,
+              .flags = strip.flags,
+            }
+          );
+        }
+
+        const auto stripGroupView = dataView.withAbsoluteOffset(getOffset(data, stripGroup));
+
+        stripGroups.push_back(
+          {
+            .vertices = stripGroupView.parseStructArray<Structs::Vtx::Vertex>(
+              stripGroup.vertOffset,
+              getCount(stripGroup.numVerts, "Failed to parse VTX vertex array"),
+              "Failed to parse VTX vertex array"
+            ),
+            .indices = stripGroupView.parseStructArray<uint16_t>(
+              stripGroup.indexOffset,
+              getCount(stripGroup.numIndices, "Failed to parse VTX index array"),
+              "Failed to parse VTX index array"
+            ),
+            .strips = std::span<const Strip>(strips).subspan(firstStrip),
+            .flags = stripGroup.flags,
+          }
+        );
+      }
+    }
+
+    size_t nextStripGroup = 0;
+    meshes.reserve(rawStripGroups.size());
+    auto stripGroupArray = rawStripGroups.begin();
+    for (const auto& meshArray : rawMeshes) {
+      for (const auto& mesh : meshArray) {
+        meshes.push_back(
+          {
+            .stripGroups = takeChildren(stripGroups, nextStripGroup, (stripGroupArray++)->size()),
+            .flags = mesh.flags,
+          }
+        );
+      }
+    }
+
+    size_t nextMesh = 0;
+    levelOfDetails.reserve(rawMeshes.size());
+    auto meshArray = rawMeshes.begin();
+    for (const auto& lodArray : rawLods) {
+      for (const auto& lod : lodArray) {
+        levelOfDetails.push_back(
+          { .meshes = takeChildren(meshes, nextMesh, (meshArray++)->size()), .switchPoint = lod.switchPoint }
+        );
+      }
+    }
+
+    size_t nextLod = 0;
+    models.reserve(rawLods.size());
+    for (const auto& lodArray : rawLods) {
+      models.push_back({ .levelOfDetails = takeChildren(levelOfDetails, nextLod, lodArray.size()) });
+    }
+
+    size_t nextModel = 0;
+    bodyParts.reserve(rawModels.size());
+    for (const auto& modelArray : rawModels) {
+      bodyParts.push_back({ .models = takeChildren(models, nextModel, modelArray.size()) });
+    }
+
+    const RawArrays<Structs::Vtx::MaterialReplacementList> rawReplacementLists{
+      dataView.parseStructArray<Structs::Vtx::MaterialReplacementList>(
+        header.materialReplacementListOffset,
+        getCount(header.numLoDs, "Failed to parse VTX material replacement lists"),
+        "Failed to parse VTX material replacement lists"
+      ),
+    };
+    const auto rawReplacements = parseChildArrays<Structs::Vtx::MaterialReplacement>(
+      data,
+      rawReplacementLists,
+      [](const Structs::Vtx::MaterialReplacementList& replacementList) {
+        return ChildArray{ .offset = replacementList.replacementOffset, .count = replacementList.replacementCount };
+      },
+      "Failed to parse VTX material replacements"
+    );
+
+    size_t nextReplacement = 0;
+    materialReplacements.reserve(getTotalSize(rawReplacements));
+    materialReplacementsByLod.reserve(rawReplacements.size());
+    for (const auto& replacementArray : rawReplacements) {
+      for (const auto& replacement : replacementArray) {
+        materialReplacements.push_back(
+          {
+            .replacementId = replacement.materialId,
+            .replacementName = dataView.withAbsoluteOffset(getOffset(data, replacement)).parseString(
+              replacement.replacementMaterialNameOffset,
+              "Failed to parse VTX material replacement name"
+            ),
+          }
+        );
+      }
+
+      materialReplacementsByLod.push_back(takeChildren(materialReplacements, nextReplacement, replacementArray.size()));
+    }
+  }
+
+  int32_t VtxView::getChecksum() const {
+    return header.checksum;
+  }
+
+  std::span<const VtxView::MaterialReplacement> VtxView::getMaterialReplacements(const int lod) const {
+    checkBounds(lod, 1, materialReplacementsByLod.size(), "Level of detail is outside range");
+    return materialReplacementsByLod[lod];
+  }
+
+  std::span<const VtxView::BodyPart> VtxView::getBodyParts() const {
+    return bodyParts;
+  }
+}
@@ -0,0 +1,162 @@
+#pragma once
+
+#include <optional>
+#include <span>
+#include <string_view>
+#include <vector>
+#include "enums.hpp"
+#include "structs/vtx.hpp"
+#include "vtx.hpp"
+
+namespace MdlParser {
+  /**
+   * Parses a .vtx file from a buffer into the same structure as Vtx, but without copying any vertex, index or string
+   * data out of the buffer.
+   * @remark Every level of the tree is stored in a single flat array, with each element viewing a run of the level
+   * @remark below it, so parsing allocates a fixed number of times however many strip groups the model has.
+   */
+  class VtxView {
+  public:
+    using Strip = Vtx::Strip;
+
+    /**
+     * A collection of primitives (strips) with common vertices and indices.
+     */
+    struct StripGroup {
+      /**
+       * The vertices used by the strips in this group, pointing into the parsed buffer.
+       * @remarks The majority of the vertex data is stored in the .vvd file, with the vertices in here mostly just pointing to that data.
+       */
+      std::span<const Structs::Vtx::Vertex> vertices;
+
+      /**
+       * The indices used by the strips in this group, pointing into the parsed buffer.
+       * Each index is an offset into the strip group's vertices.
+       */
+      std::span<const uint16_t> indices;
+
+      /**
+       * The strips (primitives) within this group.
+       */
+      std::span<const Strip> strips;
+
+      /**
+       * Bitflags describing this strip group.
+       */
+      Enums::Vtx::StripGroupFlags flags;
+    };
+
+    /**
+     * A collection of primitives grouped to be more optimised for legacy rendering APIs.
+     */
+    struct Mesh {
+      /**
+       * The groups which make up this mesh.
+       */
+      std::span<const StripGroup> stripGroups;
+
+      /**
+       * Bitflags describing this mesh.
+       */
+      Enums::Vtx::MeshFlags flags;
+    };
+
+    /**
+     * A collection of meshes to be displayed at a certain distance to the viewer.
+     */
+    struct ModelLod {
+      /**
+       * The meshes that make up this level of detail.
+       */
+      std::span<const Mesh> meshes;
+
+      /**
+       * The point (distance?) at which you should switch to (from?) this level of detail (in hammer units?).
+       */
+      float switchPoint;
+    };
+
+    /**
+     * A logical grouping of meshes that can be toggled between in a body part.
+     */
+    struct Model {
+      /**
+       * The level of details available for this model (with 0 being the highest).
+       */
+      std::span<const ModelLod> levelOfDetails;
+    };
+
+    /**
+     * A body part (or body group) is a group of models of which exactly one will be displayed at a given time.
+     */
+    struct BodyPart {
+      /**
+       * The models which can be toggled between.
+       */
+      std::span<const Model> models;
+    };
+
+    struct MaterialReplacement {
+      int16_t replacementId;
+      /**
+       * Name of the replacement material, pointing into the parsed buffer.
+       */
+      std::string_view replacementName;
+    };
+
+    /**
+     * Parses a .vtx file contained in the given buffer, validating it exactly as Vtx does.
+     * No ownership of the data is taken and nothing is copied out of it, so data must outlive the VtxView.
+     *
+     * @param data
+     * @param checksum Optional checksum to validate against the header's
+     * @throws Errors::UnsupportedVersion The VTX version is unsupported.
+     * @throws Errors::InvalidChecksum The checksum does not match the header's.
+     * @throws Errors::InvalidBody A model's LoD count does not match the header's.
+     * @throws Errors::OutOfBoundsAccess Any array, strip or string lies outside the data.
+     */
+    explicit VtxView(
+      std::span<const std::byte> data,
+      const std::optional<int32_t>& checksum = std::nullopt
+    );
+
+    ~VtxView() = default;
+    // Parents view into the flat arrays owned by this object, so copies would point back into the original
+    VtxView(const VtxView&) = delete;
+    VtxView& operator=(const VtxView&) = delete;
+    VtxView(VtxView&&) noexcept = default;
+    VtxView& operator=(VtxView&&) noexcept = default;
+
+    /**
+     * Gets the checksum shared by the MDL, VTX and VVD from the header.
+     * @remarks Can be used to loosely verify that a collection of MDL, VTX and VVD files were compiled from the same asset.
+     * @return int32_t checksum
+     */
+    [[nodiscard]] int32_t getChecksum() const;
+
+    /**
+     * Gets the material replacements for a given level of detail.
+     * @param lod
+     * @return The material replacements list.
+     * @throws Errors::OutOfBoundsAccess The level of detail does not exist.
+     */
+    [[nodiscard]] std::span<const MaterialReplacement> getMaterialReplacements(int lod) const;
+
+    /**
+     * Gets the body parts (body groups) which make up this model.
+     * @return
+     */
+    [[nodiscard]] std::span<const BodyPart> getBodyParts() const;
+
+  private:
+    Structs::Vtx::Header header{};
+    std::vector<BodyPart> bodyParts;
+    std::vector<Model> models;
+    std::vector<ModelLod> levelOfDetails;
+    std::vector<Mesh> meshes;
+    std::vector<StripGroup> stripGroups;
+    std::vector<Strip> strips;
+    std::vector<MaterialReplacement> materialReplacements;
+    std::vector<std::span<const MaterialReplacement>> materialReplacementsByLod;
+  };
+}
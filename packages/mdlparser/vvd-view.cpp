@@ -0,0 +1,185 @@
+#include "vvd-view.hpp"
+#include <algorithm>
+#include <cstdint>
+#include <optional>
+#include <source-parsers-shared/errors.hpp>
+#include <source-parsers-shared/internal/offset-data-view.hpp>
+
+namespace MdlParser {
+  using Structs::Vector4D;
+  using namespace Structs::Vvd;
+  using namespace SourceParsers::Errors;
+  using namespace SourceParsers::Internal;
+
+  namespace {
+    constexpr auto FILE_ID = u'I' + (u'D' << 8u) + (u'S' << 16u) + (u'V' << 24u);
+  }
+
+  VvdView::VvdView(const std::span<const std::byte> data, const std::optional<int32_t>& checksum) {
+    const OffsetDataView dataView(data);
+
+    header = dataView.parseStruct<Header>(0, "Failed to parse VVD header");
+
+    if (header.id != FILE_ID) {
+      throw InvalidHeader("VVD header ID does not match IDSV");
+    }
+    if (header.version != Header::SUPPORTED_VERSION) {
+      throw UnsupportedVersion("VVD version is unsupported");
+    }
+    if (checksum.has_value() && header.checksum != checksum.value()) {
+      throw InvalidChecksum("VVD checksum does not match");
+    }
+    if (header.numLoDs < 1 || header.numLoDs > MAX_NUM_LODS) {
+      throw InvalidHeader("VVD level of detail count is outside range");
+    }
+
+    const auto numVertices = header.numLoDVertices[0];
+    if (numVertices < 0 || header.numFixups < 0) {
+      throw InvalidBody("VVD vertex or fixup count is negative");
+    }
+
+    const auto sizeOfFixups = sizeof(Fixup) * header.numFixups;
+    const auto sizeOfVertices = (sizeof(Vector4D) + sizeof(Vertex)) * numVertices;
+    if (sizeof(Header) + sizeOfFixups + sizeOfVertices > data.size()) {
+      throw InvalidBody("Size of VVD with given number of vertices exceeds data size");
+    }
+
+    vertices = dataView.parseStructArray<Vertex>(header.vertexDataOffset, numVertices, "Failed to parse VVD vertices");
+    tangents = dataView.parseStructArray<Vector4D>(header.tangentDataOffset, numVertices, "Failed to parse VVD tangents");
+
+    lodVertexCounts.assign(header.numLoDs, numVertices);
+    if (header.numFixups == 0) {
+      return;
+    }
+
+    const auto fixups = dataView.parseStructArray<Fixup>(
+      header.fixupTableOffset,
+      header.numFixups,
+      "Failed to parse VVD fixups"
+    );
+
+    for (const auto& fixup : fixups) {
+      if (fixup.numVertices > 0 && fixup.sourceVertexId >= 0) {
+        checkBounds(fixup.sourceVertexId, fixup.numVertices, numVertices, "VVD fixup accesses outside vertex data");
+      }
+    }
+
+    // A fixup belongs to its own level of detail and every one above it, so each level takes the fixups at or below it
+    lodRunStarts.reserve(header.numLoDs + 1);
+    for (int32_t lod = 0; lod < header.numLoDs; lod++) {
+      lodRunStarts.push_back(runs.size());
+      size_t lodVertexCount = 0;
+
+      for (const auto& fixup : fixups) {
+        if (fixup.lod < lod || fixup.numVertices <= 0 || fixup.sourceVertexId < 0) {
+          continue;
+        }
+
+        if (lodVertexCount + fixup.numVertices > UINT32_MAX) {
+          throw InvalidBody("VVD fixups contain too many vertices");
+        }
+
+        runs.push_back(
+          {
+            .firstVertex = static_cast<uint32_t>(lodVertexCount),
+            .sourceVertex = static_cast<uint32_t>(fixup.sourceVertexId),
+            .vertexCount = static_cast<uint32_t>(fixup.numVertices),
+          }
+        );
+        lodVertexCount += fixup.numVertices;
+      }
+
+      lodVertexCounts[lod] = lodVertexCount;
+    }
+    lodRunStarts.push_back(runs.size());
+  }
+
+  int32_t VvdView::getChecksum() const {
+    return header.checksum;
+  }
+
+  int32_t VvdView::getLevelsOfDetail() const {
+    return header.numLoDs;
+  }
+
+  bool VvdView::hasFixups() const {
+    return header.numFixups != 0;
+  }
+
+  std::span<const Vertex> VvdView::getSourceVertices() const {
+    return vertices;
+  }
+
+  std::span<const Vector4D> VvdView::getSourceTangents() const {
+    return tangents;
+  }
+
+  std::span<const VvdView::VertexRun> VvdView::getVertexRuns(const int lod) const {
+    checkBounds(lod, 1, lodVertexCounts.size(), "Level of detail is outside range");
+
+    if (lodRunStarts.empty()) {
+      return {};
+    }
+
+    return std::span(runs).subspan(lodRunStarts[lod], lodRunStarts[lod + 1] - lodRunStarts[lod]);
+  }
+
+  size_t VvdView::getVertexCount(const int lod) const {
+    checkBounds(lod, 1, lodVertexCounts.size(), "Level of detail is outside range");
+    return lodVertexCounts[lod];
+  }
+
+  size_t VvdView::getSourceIndex(const size_t index, const int lod) const {
+    checkBounds(static_cast<int64_t>(index), 1, getVertexCount(lod), "VVD vertex index is outside range");
+
+    if (!hasFixups()) {
+      return index;
+    }
+
+    const auto lodRuns = getVertexRuns(lod);
+    const auto run = std::prev(
+      std::upper_bound(
+        lodRuns.begin(),
+        lodRuns.end(),
+        index,
+        [](const size_t value, const VertexRun& candidate) { return value < candidate.firstVertex; }
+      )
+    );
+
+    return run->sourceVertex + (index - run->firstVertex);
+  }
+
+  const Vertex& VvdView::getVertex(const size_t index, const int lod) const {
+    return vertices[getSourceIndex(index, lod)];
+  }
+
+  const Vector4D& VvdView::getTangent(const size_t index, const int lod) const {
+    return tangents[getSourceIndex(index, lod)];
+  }
+
+  std::vector<Vertex> VvdView::materialiseVertices(const int lod) const {
+    return materialise(vertices, lod);
+  }
+
+  std::vector<Vector4D> VvdView::materialiseTangents(const int lod) const {
+    return materialise(tangents, lod);
+  }
+
+  template<typename T>
+  std::vector<T> VvdView::materialise(const std::span<const T> source, const int lod) const {
+    const auto lodRuns = getVertexRuns(lod);
+    if (!hasFixups()) {
+      return std::vector(source.begin(), source.end());
+    }
+
+    std::vector<T> materialised;
+    materialised.reserve(getVertexCount(lod));
+
+    for (const auto& run : lodRuns) {
+      const auto first = source.begin() + run.sourceVertex;
+      materialised.insert(materialised.end(), first, first + run.vertexCount);
+    }
+
+    return materialised;
+  }
+}
@@ -0,0 +1,160 @@
+#pragma once
+
+#include <optional>
+#include <span>
+#include <vector>
+#include "structs/vvd.hpp"
+
+namespace MdlParser {
+  /**
+   * Parses a .vvd file from a buffer without copying any vertex or tangent data out of it.
+   * @remark Instead of rebuilding the vertex arrays when the file has fixups, each level of detail keeps the fixups that
+   * @remark apply to it as runs of the file's vertices. Files without fixups are loaded in constant time.
+   */
+  class VvdView {
+  public:
+    /**
+     * A run of consecutive vertices in the file, which appears at a given position in a level of detail's vertices.
+     */
+    struct VertexRun {
+      /**
+       * Index of the run's first vertex within the level of detail.
+       */
+      uint32_t firstVertex;
+      /**
+       * Index of the run's first vertex within the file's vertices.
+       */
+      uint32_t sourceVertex;
+      uint32_t vertexCount;
+    };
+
+    /**
+     * Parses a .vvd file contained in the given buffer, validating it as Vvd does along with the level of detail count.
+     * No ownership of the data is taken and nothing is copied out of it, so data must outlive the VvdView.
+     *
+     * @param data
+     * @param checksum Optional checksum to validate against the header's.
+     * @throws Errors::InvalidHeader The header ID or level of detail count is invalid.
+     * @throws Errors::UnsupportedVersion The VVD version is unsupported.
+     * @throws Errors::InvalidChecksum The checksum does not match the header's.
+     * @throws Errors::InvalidBody The vertex or fixup count is negative or does not fit in the data.
+     * @throws Errors::OutOfBoundsAccess The vertices, tangents, fixups or a fixup's vertices lie outside the data.
+     */
+    explicit VvdView(
+      std::span<const std::byte> data,
+      const std::optional<int32_t>& checksum = std::nullopt
+    );
+
+    /**
+     * Gets the checksum shared by the MDL, VTX and VVD from the header.
+     * @remarks Can be used to loosely verify that a collection of MDL, VTX and VVD files were compiled from the same asset.
+     * @return int32_t checksum.
+     */
+    [[nodiscard]] int32_t getChecksum() const;
+
+    /**
+     * Gets the number of levels of detail (LoDs) that should be present in the model.
+     * @return Number of levels.
+     */
+    [[nodiscard]] int32_t getLevelsOfDetail() const;
+
+    /**
+     * Checks whether the file has a fixup table, in which case vertices must be remapped before they can be indexed
+     * with the offsets in the MDL.
+     * @return True if there is a fixup table.
+     */
+    [[nodiscard]] bool hasFixups() const;
+
+    /**
+     * Gets the vertices as stored in the file, before any fixups are applied.
+     * @return Vertices pointing into the parsed buffer.
+     */
+    [[nodiscard]] std::span<const Structs::Vvd::Vertex> getSourceVertices() const;
+
+    /**
+     * Gets the tangents as stored in the file, before any fixups are applied.
+     * @return Tangents pointing into the parsed buffer, one for each source vertex.
+     */
+    [[nodiscard]] std::span<const Structs::Vector4D> getSourceTangents() const;
+
+    /**
+     * Gets the runs of source vertices which make up a level of detail's vertices, in order.
+     * @param lod
+     * @return The fixups applying to the level of detail, or an empty span if the file has none.
+     * @throws Errors::OutOfBoundsAccess The level of detail does not exist.
+     */
+    [[nodiscard]] std::span<const VertexRun> getVertexRuns(int lod = 0) const;
+
+    /**
+     * Gets the number of vertices in a level of detail.
+     * @param lod
+     * @return Number of vertices, which is also the number of tangents.
+     * @throws Errors::OutOfBoundsAccess The level of detail does not exist.
+     */
+    [[nodiscard]] size_t getVertexCount(int lod = 0) const;
+
+    /**
+     * Maps an index into a level of detail's vertices, as used by the MDL, to an index into the source vertices.
+     * @remark Takes constant time without fixups, and logarithmic time in the number of fixups otherwise.
+     * @param index
+     * @param lod
+     * @return Index into getSourceVertices() and getSourceTangents().
+     * @throws Errors::OutOfBoundsAccess The level of detail or index does not exist.
+     */
+    [[nodiscard]] size_t getSourceIndex(size_t index, int lod = 0) const;
+
+    /**
+     * Gets a vertex of a level of detail, with fixups applied.
+     * @param index
+     * @param lod
+     * @return
+     * @throws Errors::OutOfBoundsAccess The level of detail or index does not exist.
+     */
+    [[nodiscard]] const Structs::Vvd::Vertex& getVertex(size_t index, int lod = 0) const;
+
+    /**
+     * Gets a tangent of a level of detail, with fixups applied.
+     * @param index
+     * @param lod
+     * @return
+     * @throws Errors::OutOfBoundsAccess The level of detail or index does not exist.
+     */
+    [[nodiscard]] const Structs::Vector4D& getTangent(size_t index, int lod = 0) const;
+
+    /**
+     * Copies a level of detail's vertices into a new contiguous array, with fixups applied.
+     * @param lod
+     * @return The same vertices Vvd::getVertices() returns for the root level of detail.
+     * @throws Errors::OutOfBoundsAccess The level of detail does not exist.
+     */
+    [[nodiscard]] std::vector<Structs::Vvd::Vertex> materialiseVertices(int lod = 0) const;
+
+    /**
+     * Copies a level of detail's tangents into a new contiguous array, with fixups applied.
+     * @param lod
+     * @return The same tangents Vvd::getTangents() returns for the root level of detail.
+     * @throws Errors::OutOfBoundsAccess The level of detail does not exist.
+     */
+    [[nodiscard]] std::vector<Structs::Vector4D> materialiseTangents(int lod = 0) const;
+
+  private:
+    Structs::Vvd::Header header{};
+    std::span<const Structs::Vvd::Vertex> vertices;
+    std::span<const Structs::Vector4D> tangents;
+    /**
+     * Runs of every level of detail one after another, or empty without fixups.
+     */
+    std::vector<VertexRun> runs;
+    /**
+     * Index of each level of detail's first run in runs, followed by the total number of runs.
+     */
+    std::vector<size_t> lodRunStarts;
+    /**
+     * Number of vertices in each level of detail.
+     */
+    std::vector<size_t> lodVertexCounts;
+
+    template<typename T>
+    [[nodiscard]] std::vector<T> materialise(std::span<const T> source, int lod) const;
+  };
+}
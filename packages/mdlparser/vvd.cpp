@@ -1,4 +1,5 @@
 #include "vvd.hpp"
+#include <algorithm>
 #include <optional>
 #include <source-parsers-shared/errors.hpp>
 #include <source-parsers-shared/internal/offset-data-view.hpp>
@@ -15,7 +16,6 @@ namespace MdlParser {
 
   Vvd::Vvd(const std::span<const std::byte> data, const std::optional<int32_t>& checksum) {
     const OffsetDataView dataView(data);
-    constexpr auto rootLod = 0;
 
     header = dataView.parseStruct<Header>(0, "Failed to parse VVD header");
 
@@ -28,66 +28,71 @@ namespace MdlParser {
     if (checksum.has_value() && header.checksum != checksum.value()) {
       throw InvalidChecksum("VVD checksum does not match");
     }
+    if (header.numLoDs < 1 || header.numLoDs > MAX_NUM_LODS) {
+      throw InvalidHeader("VVD level of detail count is outside range");
+    }
+
+    const auto numVertices = header.numLoDVertices[0];
+    if (numVertices < 0 || header.numFixups < 0) {
+      throw InvalidBody("VVD vertex or fixup count is negative");
+    }
 
-    const auto numVertices = header.numLoDVertices[rootLod];
     const auto sizeOfFixups = sizeof(Fixup) * header.numFixups;
     const auto sizeOfVertices = (sizeof(Vector4D) + sizeof(Vertex)) * numVertices;
     if (sizeof(Header) + sizeOfFixups + sizeOfVertices > data.size()) {
       throw InvalidBody("Size of VVD with given number of vertices exceeds data size");
     }
 
+    const auto originalVertices = dataView.parseStructArray<Vertex>(
+      header.vertexDataOffset,
+      numVertices,
+      "Failed to parse VVD vertices"
+    );
+    const auto originalTangents = dataView.parseStructArray<Vector4D>(
+      header.tangentDataOffset,
+      numVertices,
+      "Failed to parse VVD tangents"
+    );
+
     if (header.numFixups == 0) {
-      const auto verticesSpan = dataView.parseStructArray<Vertex>(
-        header.vertexDataOffset,
-        numVertices,
-        "Failed to parse VVD vertices"
-      );
-      vertices = std::vector(verticesSpan.begin(), verticesSpan.end());
-
-      const auto tangentsSpan = dataView.parseStructArray<Vector4D>(
-        header.tangentDataOffset,
-        numVertices,
-        "Failed to parse VVD tangents"
-      );
-      tangents = std::vector(tangentsSpan.begin(), tangentsSpan.end());
-    } else {
-      const auto fixups = dataView.parseStructArray<Fixup>(
-        header.fixupTableOffset,
-        header.numFixups,
-        "Failed to parse VVD fixups"
-      );
-      const auto originalVertices = dataView.parseStructArray<Vertex>(
-        header.vertexDataOffset,
-        numVertices,
-        "Failed to parse VVD vertices"
-      );
-      const auto originalTangents = dataView.parseStructArray<Vector4D>(
-        header.tangentDataOffset,
-        numVertices,
-        "Failed to parse VVD tangents"
-      );
-
-      vertices.reserve(numVertices);
-      tangents.reserve(numVertices);
-
-      for (const auto& fixup : fixups) {
-        if (fixup.lod < rootLod || fixup.numVertices <= 0 || fixup.sourceVertexId < 0) {
-          continue;
-        }
-
-        checkBounds(fixup.sourceVertexId, fixup.numVertices, numVertices, "VVD fixup accesses outside vertex data");
-
-        vertices.insert(
-          vertices.end(),
-          originalVertices.begin() + fixup.sourceVertexId,
-          originalVertices.begin() + fixup.sourceVertexId + fixup.numVertices
-        );
-
-        tangents.insert(
-          tangents.end(),
-          originalTangents.begin() + fixup.sourceVertexId,
-          originalTangents.begin() + fixup.sourceVertexId + fixup.numVertices
-        );
+      verticesByLod.emplace_back(originalVertices.begin(), originalVertices.end());
+      tangentsByLod.emplace_back(originalTangents.begin(), originalTangents.end());
+      return;
+    }
+
+    const auto fixups = dataView.parseStructArray<Fixup>(
+      header.fixupTableOffset,
+      header.numFixups,
+      "Failed to parse VVD fixups"
+    );
+
+    verticesByLod.resize(header.numLoDs);
+    tangentsByLod.resize(header.numLoDs);
+    for (int32_t lod = 0; lod < header.numLoDs; lod++) {
+      // The header's count is only a hint, so don't let a corrupt one allocate more than the file holds
+      // Copied out first, as std::clamp would bind a reference to the packed (and possibly misaligned) field
+      const int32_t lodVertices = header.numLoDVertices[lod];
+      const auto expectedVertices = std::clamp(lodVertices, 0, numVertices);
+      verticesByLod[lod].reserve(expectedVertices);
+      tangentsByLod[lod].reserve(expectedVertices);
+    }
+
+    // A fixup belongs to its own level of detail and every one above it
+    for (const auto& fixup : fixups) {
+      if (fixup.lod < 0 || fixup.numVertices <= 0 || fixup.sourceVertexId < 0) {
+        continue;
+      }
+
+      checkBounds(fixup.sourceVertexId, fixup.numVertices, numVertices, "VVD fixup accesses outside vertex data");
+
+      const auto firstVertex = originalVertices.begin() + fixup.sourceVertexId;
+      const auto firstTangent = originalTangents.begin() + fixup.sourceVertexId;
+      const int32_t fixupLod = fixup.lod;
+      const auto lastLod = std::min(fixupLod, header.numLoDs - 1);
+
+      for (int32_t lod = 0; lod <= lastLod; lod++) {
+        verticesByLod[lod].insert(verticesByLod[lod].end(), firstVertex, firstVertex + fixup.numVertices);
+        tangentsByLod[lod].insert(tangentsByLod[lod].end(), firstTangent, firstTangent + fixup.numVertices);
       }
     }
   }
@@ -97,14 +102,31 @@ namespace MdlParser {
   }
 
   const std::vector<Vertex>& Vvd::getVertices() const {
-    return vertices;
+    return verticesByLod[0];
+  }
+
+  const std::vector<Vertex>& Vvd::getVertices(const int lod) const {
+    return verticesByLod[getLodIndex(lod)];
   }
 
   const std::vector<Vector4D>& Vvd::getTangents() const {
-    return tangents;
+    return tangentsByLod[0];
+  }
+
+  const std::vector<Vector4D>& Vvd::getTangents(const int lod) const {
+    return tangentsByLod[getLodIndex(lod)];
   }
 
   int32_t Vvd::getLevelsOfDetail() const {
     return header.numLoDs;
   }
+
+  bool Vvd::hasFixups() const {
+    return header.numFixups != 0;
+  }
+
+  size_t Vvd::getLodIndex(const int lod) const {
+    checkBounds(lod, 1, header.numLoDs, "Level of detail is outside range");
+    return verticesByLod.size() == 1 ? 0 : lod;
+  }
 }
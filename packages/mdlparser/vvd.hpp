@@ -14,6 +14,7 @@ namespace MdlParser {
     /**
      * Parses a .vvd file contained in the given buffer into an easier to use and more modern structure.
      * No ownership of the data is taken as all contents are copied into new structs.
+     * Vertices are built for every level of detail in the header, in a single pass over the fixup table.
      *
      * @param data
      * @param checksum Optional checksum to validate against the header's.
@@ -36,6 +37,14 @@ namespace MdlParser {
      */
     [[nodiscard]] const std::vector<Structs::Vvd::Vertex>& getVertices() const;
 
+    /**
+     * Gets the list of vertices for a level of detail, which the MDL's per-LoD offsets index when the file has fixups.
+     * @param lod
+     * @return List of vertices.
+     * @throws Errors::OutOfBoundsAccess The level of detail does not exist.
+     */
+    [[nodiscard]] const std::vector<Structs::Vvd::Vertex>& getVertices(int lod) const;
+
     /**
      * Gets the list of tangents in this VVD.
      * @remarks These are stored separately from the primary vertex data, and are indexed using different offsets in the MDL file.
@@ -43,15 +52,35 @@ namespace MdlParser {
      */
     [[nodiscard]] const std::vector<Structs::Vector4D>& getTangents() const;
 
+    /**
+     * Gets the list of tangents for a level of detail.
+     * @param lod
+     * @return List of tangents.
+     * @throws Errors::OutOfBoundsAccess The level of detail does not exist.
+     */
+    [[nodiscard]] const std::vector<Structs::Vector4D>& getTangents(int lod) const;
+
     /**
      * Gets the number of levels of detail (LoDs) that should be present in the model.
      * @return Number of levels.
      */
     [[nodiscard]] int32_t getLevelsOfDetail() const;
 
+    /**
+     * Checks whether the file has a fixup table, in which case each level of detail has its own vertices, indexed with
+     * the per-LoD offsets in the MDL.
+     * @return True if there is a fixup table.
+     */
+    [[nodiscard]] bool hasFixups() const;
+
   private:
     Structs::Vvd::Header header{};
-    std::vector<Structs::Vvd::Vertex> vertices;
-    std::vector<Structs::Vector4D> tangents;
+    /**
+     * Vertices of each level of detail, with the root first. Without fixups every level shares the root's.
+     */
+    std::vector<std::vector<Structs::Vvd::Vertex>> verticesByLod;
+    std::vector<std::vector<Structs::Vector4D>> tangentsByLod;
+
+    [[nodiscard]] size_t getLodIndex(int lod) const;
   };
 }
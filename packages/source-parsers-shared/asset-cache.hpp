@@ -0,0 +1,163 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+
+namespace SourceParsers {
+  /**
+   * Thread-safe cache of parsed assets keyed by path and checksum, which evicts the least recently used assets once
+   * their estimated memory usage exceeds a budget.
+   * Assets are handed out as shared, immutable handles, so an evicted asset stays alive until every handle to it is
+   * released.
+   * @tparam Asset Parsed asset type.
+   */
+  template<typename Asset>
+  class AssetCache {
+  public:
+    /**
+     * @param memoryBudget Most memory, in bytes as estimated by getAssetSize, to keep cached assets within.
+     * @param getAssetSize Estimates the memory used by an asset. Called once when it is added.
+     */
+    AssetCache(const size_t memoryBudget, std::function<size_t(const Asset& asset)> getAssetSize) :
+      memoryBudget(memoryBudget), getAssetSize(std::move(getAssetSize)) {}
+
+    /**
+     * Returns the cached asset for path and checksum, calling load to populate the cache on a miss.
+     * @remark load is called outside the lock so other threads aren't blocked, so two threads may race to load the same
+     * @remark asset. Both get the same handle, and the loser's asset is discarded.
+     * @remark Assets larger than the whole budget are returned but not kept, and don't evict anything.
+     * @param path Path of the asset, compared exactly.
+     * @param checksum Checksum identifying the asset's contents, such as the one shared by MDL, VTX and VVD headers.
+     * @param load Function to load the asset if it is not already cached.
+     * @return Shared, immutable asset.
+     */
+    [[nodiscard]] std::shared_ptr<const Asset> getOrLoad(
+      const std::string_view path,
+      const int64_t checksum,
+      const std::function<Asset()>& load
+    ) {
+      Key key{ .path = std::string(path), .checksum = checksum };
+
+      {
+        const std::lock_guard lock(mutex);
+        if (const auto it = entries.find(key); it != entries.end()) {
+          recency.splice(recency.begin(), recency, it->second.recency);
+          return it->second.asset;
+        }
+      }
+
+      auto asset = std::make_shared<const Asset>(load());
+      const auto assetSize = getAssetSize(*asset);
+
+      const std::lock_guard lock(mutex);
+      if (const auto it = entries.find(key); it != entries.end()) {
+        recency.splice(recency.begin(), recency, it->second.recency);
+        return it->second.asset;
+      }
+
+      if (assetSize > memoryBudget) {
+        return asset;
+      }
+
+      recency.push_front(key);
+      entries.try_emplace(
+        std::move(key),
+        Entry{ .asset = asset, .size = assetSize, .recency = recency.begin() }
+      );
+      memoryUsage += assetSize;
+      evictOverBudget();
+
+      return asset;
+    }
+
+    /**
+     * Gets the number of assets in the cache.
+     * @return Number of cached assets.
+     */
+    [[nodiscard]] size_t size() const {
+      const std::lock_guard lock(mutex);
+      return entries.size();
+    }
+
+    /**
+     * Gets the estimated memory used by cached assets.
+     * @return Sum of getAssetSize for every cached asset, in bytes.
+     */
+    [[nodiscard]] size_t getMemoryUsage() const {
+      const std::lock_guard lock(mutex);
+      return memoryUsage;
+    }
+
+    /**
+     * Changes the memory budget, evicting the least recently used assets until the cache is within it.
+     * @param budget Most memory, in bytes, to keep cached assets within.
+     */
+    void setMemoryBudget(const size_t budget) {
+      const std::lock_guard lock(mutex);
+      memoryBudget = budget;
+      evictOverBudget();
+    }
+
+    /**
+     * Removes all assets from the cache. Assets still referenced elsewhere are kept alive until released.
+     */
+    void clear() {
+      const std::lock_guard lock(mutex);
+      entries.clear();
+      recency.clear();
+      memoryUsage = 0;
+    }
+
+  private:
+    struct Key {
+      std::string path;
+      int64_t checksum;
+
+      bool operator==(const Key&) const = default;
+    };
+
+    struct KeyHasher {
+      size_t operator()(const Key& key) const noexcept {
+        return std::hash<std::string>{}(key.path) ^ (std::hash<int64_t>{}(key.checksum) * 0x9e3779b97f4a7c15);
+      }
+    };
+
+    struct Entry {
+      std::shared_ptr<const Asset> asset;
+      size_t size;
+      /**
+       * Position of the asset's key in the recency list.
+       */
+      typename std::list<Key>::iterator recency;
+    };
+
+    /**
+     * Evicts the least recently used assets until the cache is within its budget. The mutex must be held.
+     */
+    void evictOverBudget() {
+      while (memoryUsage > memoryBudget && !recency.empty()) {
+        const auto it = entries.find(recency.back());
+        memoryUsage -= it->second.size;
+        entries.erase(it);
+        recency.pop_back();
+      }
+    }
+
+    mutable std::mutex mutex;
+    size_t memoryBudget;
+    size_t memoryUsage = 0;
+    std::function<size_t(const Asset& asset)> getAssetSize;
+    /**
+     * Keys of every cached asset, most recently used first.
+     */
+    std::list<Key> recency;
+    std::unordered_map<Key, Entry, KeyHasher> entries;
+  };
+}
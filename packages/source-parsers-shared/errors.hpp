@@ -16,6 +16,9 @@ namespace SourceParsers::Errors {
     InvalidChecksum,
     UnsupportedVersion,
     OutOfBoundsAccess,
+    UnsupportedFormat,
+    BufferTooSmall,
+    InvalidOptions,
   };
 
   class Error : public std::runtime_error {
@@ -39,6 +42,12 @@ namespace SourceParsers::Errors {
   ERROR_FOR_REASON(UnsupportedVersion);
 
   ERROR_FOR_REASON(OutOfBoundsAccess);
+
+  ERROR_FOR_REASON(UnsupportedFormat);
+
+  ERROR_FOR_REASON(BufferTooSmall);
+
+  ERROR_FOR_REASON(InvalidOptions);
 }
 
 #undef ERROR_FOR_REASON
@@ -0,0 +1,72 @@
+#pragma once
+
+#include <bit>
+#include <cstdint>
+
+namespace SourceParsers::Internal {
+  /**
+   * Converts an IEEE 754 half precision float to single precision. Exact for every input, including subnormals,
+   * infinities and NaN.
+   */
+  inline float halfToFloat(const uint16_t half) {
+    const uint32_t sign = static_cast<uint32_t>(half & 0x8000u) << 16u;
+    const uint32_t exponent = (half >> 10u) & 0x1fu;
+    const uint32_t mantissa = half & 0x3ffu;
+
+    if (exponent == 0) {
+      // Zero or subnormal, which is exactly representable as mantissa * 2^-24
+      const auto magnitude = static_cast<float>(mantissa) * (1.0f / 16777216.0f);
+      return sign ? -magnitude : magnitude;
+    }
+    if (exponent == 0x1f) {
+      return std::bit_cast<float>(sign | 0x7f800000u | mantissa << 13u);
+    }
+
+    return std::bit_cast<float>(sign | (exponent + 112u) << 23u | mantissa << 13u);
+  }
+
+  /**
+   * Converts a single precision float to IEEE 754 half precision, rounding to nearest even. Values too large for a
+   * half become infinity, and NaN stays NaN.
+   */
+  inline uint16_t floatToHalf(const float value) {
+    const auto bits = std::bit_cast<uint32_t>(value);
+    const auto sign = static_cast<uint16_t>((bits >> 16u) & 0x8000u);
+    const uint32_t magnitude = bits & 0x7fffffffu;
+
+    if (magnitude >= 0x7f800000u) {
+      return static_cast<uint16_t>(sign | 0x7c00u | (magnitude > 0x7f800000u ? 0x200u : 0u));
+    }
+    // 65520 and above round up past the largest finite half
+    if (magnitude >= 0x477ff000u) {
+      return static_cast<uint16_t>(sign | 0x7c00u);
+    }
+    // Below half the smallest subnormal, which rounds to zero
+    if (magnitude < 0x33000000u) {
+      return sign;
+    }
+
+    uint32_t half;
+    uint32_t remainder;
+    uint32_t halfway;
+    if (magnitude < 0x38800000u) {
+      // Subnormal half, so shift the mantissa (with its implicit bit) down to units of 2^-24
+      const uint32_t shift = 126u - (magnitude >> 23u);
+      const uint32_t mantissa = (magnitude & 0x7fffffu) | 0x800000u;
+      half = mantissa >> shift;
+      remainder = mantissa & ((1u << shift) - 1u);
+      halfway = 1u << (shift - 1u);
+    } else {
+      // Rebias the exponent from 127 to 15. A carry out of the mantissa when rounding correctly bumps the exponent.
+      half = (magnitude - 0x38000000u) >> 13u;
+      remainder = magnitude & 0x1fffu;
+      halfway = 0x1000u;
+    }
+
+    if (remainder > halfway || (remainder == halfway && (half & 1u))) {
+      half++;
+    }
+
+    return static_cast<uint16_t>(sign | half);
+  }
+}
@@ -0,0 +1,74 @@
+#include "parallel-for.hpp"
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <mutex>
+#include <system_error>
+#include <thread>
+#include <vector>
+
+namespace SourceParsers::Internal {
+  unsigned int getWorkerCount(const unsigned int requestedThreads, const size_t workItems) {
+    auto threads = requestedThreads == 0 ? std::thread::hardware_concurrency() : requestedThreads;
+    threads = std::max(threads, 1u);
+
+    return static_cast<unsigned int>(std::min<size_t>(threads, std::max<size_t>(workItems, 1)));
+  }
+
+  void parallelFor(const size_t count, const unsigned int threadCount, const std::function<void(size_t index)>& body) {
+    const auto workers = getWorkerCount(threadCount, count);
+
+    if (workers <= 1) {
+      for (size_t i = 0; i < count; i++) {
+        body(i);
+      }
+      return;
+    }
+
+    std::atomic<size_t> nextIndex = 0;
+    std::atomic<bool> failed = false;
+    std::exception_ptr firstException;
+    std::mutex exceptionMutex;
+
+    const auto work = [&]() {
+      while (!failed.load(std::memory_order_relaxed)) {
+        const auto index = nextIndex.fetch_add(1, std::memory_order_relaxed);
+        if (index >= count) {
+          return;
+        }
+
+        try {
+          body(index);
+        } catch (...) {
+          const std::lock_guard lock(exceptionMutex);
+          if (!firstException) {
+            firstException = std::current_exception();
+          }
+          failed = true;
+        }
+      }
+    };
+
+    std::vector<std::thread> threads;
+    threads.reserve(workers - 1);
+    for (unsigned int i = 1; i < workers; i++) {
+      try {
+        threads.emplace_back(work);
+      } catch (const std::system_error&) {
+        // Out of threads, so the workers already started and the calling thread share the remaining indices
+        break;
+      }
+    }
+
+    // The calling thread takes a share of the work rather than idling on join
+    work();
+
+    for (auto& thread : threads) {
+      thread.join();
+    }
+
+    if (firstException) {
+      std::rethrow_exception(firstException);
+    }
+  }
+}
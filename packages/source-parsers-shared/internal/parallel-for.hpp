@@ -0,0 +1,22 @@
+#pragma once
+
+#include <cstddef>
+#include <functional>
+
+namespace SourceParsers::Internal {
+  /**
+   * Resolves a requested worker count, where 0 means one per hardware thread, clamped to the amount of work available.
+   */
+  [[nodiscard]] unsigned int getWorkerCount(unsigned int requestedThreads, size_t workItems);
+
+  /**
+   * Calls body once for every index in [0, count), spread across a pool of worker threads.
+   * Workers claim indices one at a time, so uneven item costs still balance across the pool.
+   * If any call throws, remaining indices are skipped and the first exception is rethrown on the calling thread.
+   * If worker threads can't be started, the indices are spread across those which were, and the calling thread.
+   * @param count Number of indices to process.
+   * @param threadCount Number of workers to use, or 0 for one per hardware thread.
+   * @param body Function to call with each index.
+   */
+  void parallelFor(size_t count, unsigned int threadCount, const std::function<void(size_t index)>& body);
+}
@@ -0,0 +1,35 @@
+#pragma once
+
+#include <array>
+#include <cmath>
+
+namespace SourceParsers::Internal {
+  using Float3 = std::array<float, 3>;
+
+  inline Float3 subtract(const Float3& a, const Float3& b) {
+    return { a[0] - b[0], a[1] - b[1], a[2] - b[2] };
+  }
+
+  inline float dot(const Float3& a, const Float3& b) {
+    return a[0] * b[0] + a[1] * b[1] + a[2] * b[2];
+  }
+
+  inline float length(const Float3& vector) {
+    return std::sqrt(dot(vector, vector));
+  }
+
+  /**
+   * Gets the normal of a triangle wound clockwise when seen from its front, as every triangle the parsers generate is.
+   * @return Normal pointing out of the front, with a length of twice the triangle's area.
+   */
+  inline Float3 getFrontNormal(const Float3& p0, const Float3& p1, const Float3& p2) {
+    const auto edge1 = subtract(p2, p0);
+    const auto edge2 = subtract(p1, p0);
+
+    return {
+      edge1[1] * edge2[2] - edge1[2] * edge2[1],
+      edge1[2] * edge2[0] - edge1[0] * edge2[2],
+      edge1[0] * edge2[1] - edge1[1] * edge2[0],
+    };
+  }
+}
@@ -0,0 +1,403 @@
+#include "mesh-optimisation.hpp"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <source-parsers-shared/errors.hpp>
+#include <source-parsers-shared/internal/check-bounds.hpp>
+#include <source-parsers-shared/internal/parallel-for.hpp>
+#include <source-parsers-shared/internal/triangle-geometry.hpp>
+
+namespace SourceParsers::MeshOptimisation {
+  using namespace Errors;
+  using namespace Internal;
+
+  namespace {
+    constexpr auto NO_VERTEX = std::numeric_limits<uint32_t>::max();
+
+    void checkTriangleList(const std::span<const uint32_t> indices) {
+      if (indices.size() % 3 != 0) {
+        throw InvalidBody("Index count is not a multiple of 3");
+      }
+    }
+
+    /**
+     * Vertex to triangle adjacency of a triangle list, with vertices rebased so the lowest index used is 0.
+     */
+    struct Adjacency {
+      uint32_t baseVertex = 0;
+      /**
+       * Number of triangles using each vertex.
+       */
+      std::vector<uint32_t> triangleCounts;
+      /**
+       * Index of each vertex's first triangle in triangles, followed by the total.
+       */
+      std::vector<uint32_t> offsets;
+      std::vector<uint32_t> triangles;
+
+      [[nodiscard]] std::span<const uint32_t> getTriangles(const uint32_t vertex) const {
+        return std::span(triangles).subspan(offsets[vertex], offsets[vertex + 1] - offsets[vertex]);
+      }
+    };
+
+    Adjacency buildAdjacency(const std::span<const uint32_t> indices) {
+      Adjacency adjacency;
+      const auto [minIndex, maxIndex] = std::ranges::minmax_element(indices);
+      adjacency.baseVertex = *minIndex;
+      const size_t vertexCount = static_cast<size_t>(*maxIndex - *minIndex) + 1;
+
+      adjacency.triangleCounts.assign(vertexCount, 0);
+      for (const auto index : indices) {
+        adjacency.triangleCounts[index - adjacency.baseVertex]++;
+      }
+
+      adjacency.offsets.resize(vertexCount + 1);
+      adjacency.offsets[0] = 0;
+      for (size_t vertex = 0; vertex < vertexCount; vertex++) {
+        adjacency.offsets[vertex + 1] = adjacency.offsets[vertex] + adjacency.triangleCounts[vertex];
+      }
+
+      std::vector<uint32_t> nextSlot(adjacency.offsets.begin(), adjacency.offsets.end() - 1);
+      adjacency.triangles.resize(indices.size());
+      for (size_t i = 0; i < indices.size(); i++) {
+        adjacency.triangles[nextSlot[indices[i] - adjacency.baseVertex]++] = static_cast<uint32_t>(i / 3);
+      }
+
+      return adjacency;
+    }
+
+    /**
+     * FIFO post-transform cache, modelled with the time each vertex was last loaded.
+     */
+    class CacheSimulator {
+    public:
+      /**
+       * @param indices Triangle list whose vertices will be loaded, used to size the cache's bookkeeping.
+       * @param cacheSize
+       */
+      CacheSimulator(const std::span<const uint32_t> indices, const uint32_t cacheSize) :
+        cacheSize(cacheSize), timestamp(cacheSize + 1) {
+        const auto [minIndex, maxIndex] = std::ranges::minmax_element(indices);
+        baseVertex = *minIndex;
+        cacheTimes.assign(static_cast<size_t>(*maxIndex - *minIndex) + 1, 0);
+      }
+
+      /**
+       * Loads a vertex into the cache if it is not already there.
+       * @return 1 on a cache miss, otherwise 0.
+       */
+      uint32_t load(const uint32_t index) {
+        auto& cacheTime = cacheTimes[index - baseVertex];
+        if (timestamp - cacheTime <= cacheSize) {
+          return 0;
+        }
+
+        cacheTime = timestamp++;
+        return 1;
+      }
+
+      /**
+       * Evicts every vertex.
+       */
+      void reset() {
+        timestamp += cacheSize + 1;
+      }
+
+    private:
+      uint32_t cacheSize;
+      uint32_t timestamp;
+      uint32_t baseVertex = 0;
+      std::vector<uint32_t> cacheTimes;
+    };
+
+    uint32_t loadTriangle(CacheSimulator& cache, const std::span<const uint32_t> indices, const size_t triangle) {
+      return cache.load(indices[triangle * 3]) + cache.load(indices[triangle * 3 + 1]) +
+        cache.load(indices[triangle * 3 + 2]);
+    }
+
+    /**
+     * Splits a cache optimised triangle list into clusters which can be reordered without losing much cache efficiency.
+     * @return Index of each cluster's first triangle, followed by the triangle count.
+     */
+    std::vector<size_t> findClusters(
+      const std::span<const uint32_t> indices,
+      const float threshold,
+      const uint32_t cacheSize
+    ) {
+      const auto triangleCount = indices.size() / 3;
+      CacheSimulator cache(indices, cacheSize);
+
+      // Triangles missing on every vertex are where Tipsify jumped to a new fan, so the order already breaks there
+      std::vector<size_t> hardBoundaries{ 0 };
+      for (size_t triangle = 0; triangle < triangleCount; triangle++) {
+        if (loadTriangle(cache, indices, triangle) == 3 && triangle > 0) {
+          hardBoundaries.push_back(triangle);
+        }
+      }
+      hardBoundaries.push_back(triangleCount);
+
+      // Within each, split again wherever the cache miss rate so far is close to the whole cluster's
+      std::vector<size_t> boundaries;
+      for (size_t hard = 0; hard + 1 < hardBoundaries.size(); hard++) {
+        const auto start = hardBoundaries[hard];
+        const auto end = hardBoundaries[hard + 1];
+
+        cache.reset();
+        uint32_t clusterMisses = 0;
+        for (auto triangle = start; triangle < end; triangle++) {
+          clusterMisses += loadTriangle(cache, indices, triangle);
+        }
+        const auto missLimit = threshold * static_cast<float>(clusterMisses) / static_cast<float>(end - start);
+
+        cache.reset();
+        boundaries.push_back(start);
+        uint32_t misses = 0;
+        size_t triangles = 0;
+        for (auto triangle = start; triangle < end; triangle++) {
+          misses += loadTriangle(cache, indices, triangle);
+          triangles++;
+
+          if (triangle + 1 < end && static_cast<float>(misses) <= missLimit * static_cast<float>(triangles)) {
+            boundaries.push_back(triangle + 1);
+            cache.reset();
+            misses = 0;
+            triangles = 0;
+          }
+        }
+      }
+      boundaries.push_back(triangleCount);
+
+      return boundaries;
+    }
+  }
+
+  void optimiseVertexCache(const std::span<uint32_t> indices, const uint32_t cacheSize) {
+    checkTriangleList(indices);
+    if (indices.empty()) {
+      return;
+    }
+
+    const auto adjacency = buildAdjacency(indices);
+    const auto vertexCount = adjacency.triangleCounts.size();
+    auto liveTriangles = adjacency.triangleCounts;
+    std::vector<bool> emitted(indices.size() / 3, false);
+    std::vector<uint32_t> cacheTimes(vertexCount, 0);
+    uint32_t timestamp = cacheSize + 1;
+
+    std::vector<uint32_t> output;
+    output.reserve(indices.size());
+    std::vector<uint32_t> deadEnds;
+    std::vector<uint32_t> candidates;
+    uint32_t nextUnvisited = 0;
+    auto fanVertex = 0u;
+
+    while (fanVertex != NO_VERTEX) {
+      candidates.clear();
+
+      for (const auto triangle : adjacency.getTriangles(fanVertex)) {
+        if (emitted[triangle]) {
+          continue;
+        }
+
+        for (size_t corner = 0; corner < 3; corner++) {
+          const auto index = indices[triangle * 3 + corner];
+          const auto vertex = index - adjacency.baseVertex;
+
+          output.push_back(index);
+          deadEnds.push_back(vertex);
+          candidates.push_back(vertex);
+          liveTriangles[vertex]--;
+
+          if (timestamp - cacheTimes[vertex] > cacheSize) {
+            cacheTimes[vertex] = timestamp++;
+          }
+        }
+
+        emitted[triangle] = true;
+      }
+
+      // Prefer the candidate which entered the cache earliest but will still be in it once its fan is emitted
+      fanVertex = NO_VERTEX;
+      int64_t bestPriority = -1;
+      for (const auto vertex : candidates) {
+        if (liveTriangles[vertex] == 0) {
+          continue;
+        }
+
+        int64_t priority = 0;
+        const auto age = timestamp - cacheTimes[vertex];
+        if (age + 2 * static_cast<int64_t>(liveTriangles[vertex]) <= cacheSize) {
+          priority = age;
+        }
+
+        if (priority > bestPriority) {
+          bestPriority = priority;
+          fanVertex = vertex;
+        }
+      }
+
+      if (fanVertex != NO_VERTEX) {
+        continue;
+      }
+
+      // Otherwise fall back to a recently used vertex with triangles left, then to the next one in index order
+      while (!deadEnds.empty() && fanVertex == NO_VERTEX) {
+        const auto vertex = deadEnds.back();
+        deadEnds.pop_back();
+
+        if (liveTriangles[vertex] > 0) {
+          fanVertex = vertex;
+        }
+      }
+
+      while (nextUnvisited < vertexCount && fanVertex == NO_VERTEX) {
+        if (liveTriangles[nextUnvisited] > 0) {
+          fanVertex = nextUnvisited;
+        }
+        nextUnvisited++;
+      }
+    }
+
+    std::ranges::copy(output, indices.begin());
+  }
+
+  void optimiseOverdraw(
+    const std::span<uint32_t> indices,
+    const std::span<const Position> positions,
+    const float threshold,
+    const uint32_t cacheSize
+  ) {
+    checkTriangleList(indices);
+    for (const auto index : indices) {
+      checkBounds(index, 1, positions.size(), "Vertex index is outside positions");
+    }
+
+    const auto triangleCount = indices.size() / 3;
+    if (triangleCount == 0) {
+      return;
+    }
+
+    const auto boundaries = findClusters(indices, threshold, cacheSize);
+    const auto clusterCount = boundaries.size() - 1;
+
+    // Area weighted centroid and normal of every cluster, and of the whole mesh
+    std::vector<Position> clusterCentroids(clusterCount, { 0, 0, 0 });
+    std::vector<Position> clusterNormals(clusterCount, { 0, 0, 0 });
+    std::vector<float> clusterAreas(clusterCount, 0);
+    Position meshCentroid{ 0, 0, 0 };
+    float meshArea = 0;
+
+    for (size_t cluster = 0; cluster < clusterCount; cluster++) {
+      for (auto triangle = boundaries[cluster]; triangle < boundaries[cluster + 1]; triangle++) {
+        const auto& p0 = positions[indices[triangle * 3]];
+        const auto& p1 = positions[indices[triangle * 3 + 1]];
+        const auto& p2 = positions[indices[triangle * 3 + 2]];
+
+        const auto normal = getFrontNormal(p0, p1, p2);
+        const auto area = length(normal);
+
+        for (size_t axis = 0; axis < 3; axis++) {
+          const auto centroid = (p0[axis] + p1[axis] + p2[axis]) / 3;
+          clusterCentroids[cluster][axis] += centroid * area;
+          clusterNormals[cluster][axis] += normal[axis];
+          meshCentroid[axis] += centroid * area;
+        }
+        clusterAreas[cluster] += area;
+        meshArea += area;
+      }
+    }
+
+    if (meshArea > 0) {
+      for (auto& axis : meshCentroid) {
+        axis /= meshArea;
+      }
+    }
+
+    // Clusters facing away from the middle of the mesh are more likely to occlude the rest, so they are drawn first
+    std::vector<float> sortKeys(clusterCount, 0);
+    for (size_t cluster = 0; cluster < clusterCount; cluster++) {
+      const auto& normal = clusterNormals[cluster];
+      const auto normalLength = length(normal);
+      if (clusterAreas[cluster] <= 0 || normalLength <= 0) {
+        continue;
+      }
+
+      for (size_t axis = 0; axis < 3; axis++) {
+        const auto offset = clusterCentroids[cluster][axis] / clusterAreas[cluster] - meshCentroid[axis];
+        sortKeys[cluster] += offset * normal[axis] / normalLength;
+      }
+    }
+
+    std::vector<size_t> order(clusterCount);
+    for (size_t cluster = 0; cluster < clusterCount; cluster++) {
+      order[cluster] = cluster;
+    }
+    std::ranges::stable_sort(order, [&](const size_t a, const size_t b) { return sortKeys[a] > sortKeys[b]; });
+
+    std::vector<uint32_t> output;
+    output.reserve(indices.size());
+    for (const auto cluster : order) {
+      output.insert(
+        output.end(),
+        indices.begin() + static_cast<ptrdiff_t>(boundaries[cluster] * 3),
+        indices.begin() + static_cast<ptrdiff_t>(boundaries[cluster + 1] * 3)
+      );
+    }
+
+    std::ranges::copy(output, indices.begin());
+  }
+
+  std::vector<uint32_t> optimiseVertexFetchRemap(const std::span<uint32_t> indices, const size_t vertexCount) {
+    for (const auto index : indices) {
+      checkBounds(index, 1, vertexCount, "Vertex index is outside vertex buffer");
+    }
+
+    std::vector<uint32_t> remap(vertexCount, NO_VERTEX);
+    uint32_t nextVertex = 0;
+
+    for (auto& index : indices) {
+      if (remap[index] == NO_VERTEX) {
+        remap[index] = nextVertex++;
+      }
+      index = remap[index];
+    }
+
+    for (auto& vertex : remap) {
+      if (vertex == NO_VERTEX) {
+        vertex = nextVertex++;
+      }
+    }
+
+    return remap;
+  }
+
+  void optimiseRanges(
+    const std::span<uint32_t> indices,
+    const std::span<const IndexRange> ranges,
+    const std::span<const Position> positions,
+    const Options& options
+  ) {
+    for (const auto& range : ranges) {
+      if (range.indexCount % 3 != 0) {
+        throw InvalidBody("Index range is not a whole number of triangles");
+      }
+      if (range.indexCount > 0) {
+        checkBounds(range.firstIndex, range.indexCount, indices.size(), "Index range is outside index buffer");
+      }
+    }
+
+    if (!options.vertexCache) {
+      return;
+    }
+
+    parallelFor(ranges.size(), options.threadCount, [&](const size_t rangeIndex) {
+      const auto& range = ranges[rangeIndex];
+      const auto rangeIndices = indices.subspan(range.firstIndex, range.indexCount);
+
+      optimiseVertexCache(rangeIndices, options.cacheSize);
+      if (options.overdraw && !positions.empty()) {
+        optimiseOverdraw(rangeIndices, positions, options.overdrawThreshold, options.cacheSize);
+      }
+    });
+  }
+}
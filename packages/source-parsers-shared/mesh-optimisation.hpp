@@ -0,0 +1,158 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+/**
+ * Post-processing for exported triangle list index buffers, so they render faster on GPUs.
+ */
+namespace SourceParsers::MeshOptimisation {
+  using Position = std::array<float, 3>;
+
+  /**
+   * A run of whole triangles in an index buffer which is optimised on its own, such as one draw call.
+   */
+  struct IndexRange {
+    uint32_t firstIndex;
+    uint32_t indexCount;
+  };
+
+  /**
+   * Options controlling which optimisation passes run.
+   */
+  struct Options {
+    /**
+     * Number of vertices the post-transform cache is modelled as holding.
+     */
+    uint32_t cacheSize = 16;
+    /**
+     * Whether to reorder triangles for post-transform cache hits.
+     */
+    bool vertexCache = true;
+    /**
+     * Whether to reorder clusters of triangles so outward facing ones are drawn first, reducing overdraw. Requires
+     * vertexCache, and positions to be given.
+     */
+    bool overdraw = true;
+    /**
+     * How much worse the cache miss rate may get to give the overdraw pass more clusters to sort. Values near 1 keep
+     * the cache efficiency of the vertex cache pass, and higher values trade cache hits for less overdraw.
+     */
+    float overdrawThreshold = 1.05f;
+    /**
+     * Whether to reorder vertices into the order they are first used, so the vertex fetch reads memory sequentially.
+     * Only applies to functions given the vertex buffer.
+     */
+    bool vertexFetch = true;
+    /**
+     * Number of threads to optimise ranges with. 0 uses the number of hardware threads.
+     */
+    unsigned int threadCount = 0;
+  };
+
+  /**
+   * Reorders the triangles of a triangle list for post-transform vertex cache hits, using Tipsify.
+   * @remark Runs in linear time, with memory proportional to the span of vertex indices used rather than the whole
+   * @remark vertex buffer, so small ranges of large buffers are cheap.
+   * @param indices Triangle list to reorder in place. Its length must be a multiple of 3.
+   * @param cacheSize Number of vertices the cache is modelled as holding.
+   * @throws Errors::InvalidBody The length of indices is not a multiple of 3.
+   */
+  void optimiseVertexCache(std::span<uint32_t> indices, uint32_t cacheSize = 16);
+
+  /**
+   * Reorders clusters of triangles of a cache optimised triangle list so outward facing ones are drawn first, which
+   * lets the depth test reject more of the triangles behind them.
+   * @remark Triangles are taken to be wound clockwise when seen from the front, as the parsers generate them.
+   * @param indices Triangle list from optimiseVertexCache to reorder in place.
+   * @param positions Position of every vertex the indices refer to.
+   * @param threshold Ratio by which the cache miss rate may increase, to split the mesh into more clusters.
+   * @param cacheSize Cache size used by optimiseVertexCache.
+   * @throws Errors::InvalidBody The length of indices is not a multiple of 3.
+   * @throws Errors::OutOfBoundsAccess An index lies outside positions.
+   */
+  void optimiseOverdraw(
+    std::span<uint32_t> indices,
+    std::span<const Position> positions,
+    float threshold = 1.05f,
+    uint32_t cacheSize = 16
+  );
+
+  /**
+   * Renumbers vertices into the order they are first used by the triangle list.
+   * @param indices Triangle list to renumber in place.
+   * @param vertexCount Number of vertices in the vertex buffer.
+   * @return New index of each vertex. Vertices unused by the triangle list keep their relative order after all used ones.
+   * @throws Errors::OutOfBoundsAccess An index lies outside the vertex buffer.
+   */
+  [[nodiscard]] std::vector<uint32_t> optimiseVertexFetchRemap(std::span<uint32_t> indices, size_t vertexCount);
+
+  /**
+   * Reorders a vertex buffer into the order its vertices are first used by the triangle list, and renumbers the
+   * triangle list to match.
+   * @param indices Triangle list to renumber in place.
+   * @param vertices Vertex buffer to reorder in place.
+   * @throws Errors::OutOfBoundsAccess An index lies outside the vertex buffer.
+   */
+  template<typename Vertex>
+  void optimiseVertexFetch(const std::span<uint32_t> indices, const std::span<Vertex> vertices) {
+    const auto remap = optimiseVertexFetchRemap(indices, vertices.size());
+    const std::vector<Vertex> original(vertices.begin(), vertices.end());
+
+    for (size_t vertex = 0; vertex < original.size(); vertex++) {
+      vertices[remap[vertex]] = original[vertex];
+    }
+  }
+
+  /**
+   * Runs the vertex cache and overdraw passes over each range of an index buffer in parallel. Triangles never move
+   * between ranges.
+   * @param indices Triangle list containing every range.
+   * @param ranges Ranges to optimise, which must not overlap.
+   * @param positions Position of every vertex the indices refer to, or empty to skip the overdraw pass.
+   * @param options Passes to run.
+   * @throws Errors::InvalidBody A range is not a whole number of triangles.
+   * @throws Errors::OutOfBoundsAccess A range lies outside indices, or an index lies outside positions.
+   */
+  void optimiseRanges(
+    std::span<uint32_t> indices,
+    std::span<const IndexRange> ranges,
+    std::span<const Position> positions,
+    const Options& options = {}
+  );
+
+  /**
+   * Runs every enabled pass over a mesh: the vertex cache and overdraw passes over each range in parallel, then the
+   * vertex fetch pass over the whole buffer.
+   * @param indices Triangle list containing every range.
+   * @param ranges Ranges to optimise, which must not overlap.
+   * @param vertices Vertex buffer, whose vertices must have a position member with x, y and z.
+   * @param options Passes to run.
+   * @throws Errors::InvalidBody A range is not a whole number of triangles.
+   * @throws Errors::OutOfBoundsAccess A range lies outside indices, or an index lies outside vertices.
+   */
+  template<typename Vertex>
+  void optimiseMesh(
+    const std::span<uint32_t> indices,
+    const std::span<const IndexRange> ranges,
+    const std::span<Vertex> vertices,
+    const Options& options = {}
+  ) {
+    std::vector<Position> positions;
+    if (options.vertexCache && options.overdraw) {
+      positions.reserve(vertices.size());
+      for (const auto& vertex : vertices) {
+        positions.push_back({ vertex.position.x, vertex.position.y, vertex.position.z });
+      }
+    }
+
+    optimiseRanges(indices, ranges, positions, options);
+
+    if (options.vertexFetch) {
+      optimiseVertexFetch(indices, vertices);
+    }
+  }
+}
@@ -0,0 +1,256 @@
+#include "meshlets.hpp"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <utility>
+#include <source-parsers-shared/errors.hpp>
+#include <source-parsers-shared/internal/check-bounds.hpp>
+#include <source-parsers-shared/internal/parallel-for.hpp>
+#include <source-parsers-shared/internal/triangle-geometry.hpp>
+
+namespace SourceParsers::Meshlets {
+  using namespace Errors;
+  using namespace Internal;
+
+  namespace {
+    constexpr auto NO_LOCAL_VERTEX = std::numeric_limits<uint16_t>::max();
+    /**
+     * Smallest spread of normals, as the cosine to the cone axis, which still makes a useful cone.
+     */
+    constexpr float MIN_CONE_DOT = 0.1f;
+
+    MeshletBounds computeBounds(
+      const std::span<const uint32_t> meshletVertices,
+      const std::span<const uint8_t> meshletTriangles,
+      const std::span<const Position> positions
+    ) {
+      MeshletBounds bounds{};
+
+      // Sphere around the box containing the vertices, which is quick and close to minimal for compact meshlets
+      auto min = positions[meshletVertices.front()];
+      auto max = min;
+      for (const auto vertex : meshletVertices) {
+        for (size_t axis = 0; axis < 3; axis++) {
+          min[axis] = std::min(min[axis], positions[vertex][axis]);
+          max[axis] = std::max(max[axis], positions[vertex][axis]);
+        }
+      }
+      for (size_t axis = 0; axis < 3; axis++) {
+        bounds.center[axis] = (min[axis] + max[axis]) / 2;
+      }
+      for (const auto vertex : meshletVertices) {
+        bounds.radius = std::max(bounds.radius, length(subtract(positions[vertex], bounds.center)));
+      }
+
+      // Unit front normal of every triangle with any area, and a point on its plane
+      std::vector<std::pair<Float3, Float3>> planes;
+      planes.reserve(meshletTriangles.size() / 3);
+      Float3 axis{ 0, 0, 0 };
+      for (size_t corner = 0; corner + 3 <= meshletTriangles.size(); corner += 3) {
+        const auto& p0 = positions[meshletVertices[meshletTriangles[corner]]];
+        const auto normal = getFrontNormal(
+          p0,
+          positions[meshletVertices[meshletTriangles[corner + 1]]],
+          positions[meshletVertices[meshletTriangles[corner + 2]]]
+        );
+        const auto normalLength = length(normal);
+        if (normalLength <= 0) {
+          continue;
+        }
+
+        planes.emplace_back(Float3{ normal[0] / normalLength, normal[1] / normalLength, normal[2] / normalLength }, p0);
+        for (size_t component = 0; component < 3; component++) {
+          axis[component] += planes.back().first[component];
+        }
+      }
+
+      bounds.coneApex = bounds.center;
+      bounds.coneCutoff = 1;
+      const auto axisLength = length(axis);
+      if (axisLength <= 0) {
+        return bounds;
+      }
+      for (auto& component : axis) {
+        component /= axisLength;
+      }
+      bounds.coneAxis = axis;
+
+      auto minDot = 1.f;
+      for (const auto& [normal, point] : planes) {
+        minDot = std::min(minDot, dot(axis, normal));
+      }
+      if (minDot <= MIN_CONE_DOT) {
+        return bounds;
+      }
+
+      // Move the apex back along the axis until every triangle's plane lies in front of it
+      float maxDistance = 0;
+      for (const auto& [normal, point] : planes) {
+        maxDistance = std::max(maxDistance, dot(subtract(bounds.center, point), normal) / dot(axis, normal));
+      }
+
+      for (size_t component = 0; component < 3; component++) {
+        bounds.coneApex[component] = bounds.center[component] - axis[component] * maxDistance;
+      }
+      bounds.coneCutoff = std::sqrt(1 - minDot * minDot);
+
+      return bounds;
+    }
+
+    /**
+     * Splits one range into meshlets, adding triangles in order until either limit would be exceeded.
+     */
+    MeshletBuffer buildRange(
+      const std::span<const uint32_t> indices,
+      const std::span<const Position> positions,
+      const Options& options
+    ) {
+      MeshletBuffer buffer;
+      if (indices.empty()) {
+        return buffer;
+      }
+
+      const auto [minIndex, maxIndex] = std::ranges::minmax_element(indices);
+      const auto baseVertex = *minIndex;
+      std::vector<uint16_t> localVertices(static_cast<size_t>(*maxIndex - *minIndex) + 1, NO_LOCAL_VERTEX);
+      Meshlet meshlet{ .vertexOffset = 0, .triangleOffset = 0, .vertexCount = 0, .triangleCount = 0 };
+
+      const auto finishMeshlet = [&]() {
+        const auto meshletVertices = std::span(buffer.vertices).subspan(meshlet.vertexOffset);
+        for (const auto vertex : meshletVertices) {
+          localVertices[vertex - baseVertex] = NO_LOCAL_VERTEX;
+        }
+
+        buffer.bounds.push_back(
+          computeBounds(
+            meshletVertices,
+            std::span(buffer.triangles).subspan(meshlet.triangleOffset, meshlet.triangleCount * 3),
+            positions
+          )
+        );
+        buffer.meshlets.push_back(meshlet);
+
+        buffer.triangles.resize((buffer.triangles.size() + 3) & ~size_t{ 3 }, 0);
+        meshlet = {
+          .vertexOffset = static_cast<uint32_t>(buffer.vertices.size()),
+          .triangleOffset = static_cast<uint32_t>(buffer.triangles.size()),
+          .vertexCount = 0,
+          .triangleCount = 0,
+        };
+      };
+
+      for (size_t corner = 0; corner < indices.size(); corner += 3) {
+        const auto triangle = indices.subspan(corner, 3);
+
+        uint32_t newVertices = 0;
+        for (size_t i = 0; i < 3; i++) {
+          const auto isRepeat = (i > 0 && triangle[i] == triangle[0]) || (i > 1 && triangle[i] == triangle[1]);
+          newVertices += !isRepeat && localVertices[triangle[i] - baseVertex] == NO_LOCAL_VERTEX;
+        }
+
+        if (
+          meshlet.vertexCount + newVertices > options.maxVertices ||
+          meshlet.triangleCount + 1 > options.maxTriangles
+        ) {
+          finishMeshlet();
+        }
+
+        for (const auto index : triangle) {
+          auto& localVertex = localVertices[index - baseVertex];
+          if (localVertex == NO_LOCAL_VERTEX) {
+            localVertex = static_cast<uint16_t>(meshlet.vertexCount++);
+            buffer.vertices.push_back(index);
+          }
+
+          buffer.triangles.push_back(static_cast<uint8_t>(localVertex));
+        }
+        meshlet.triangleCount++;
+      }
+
+      finishMeshlet();
+
+      return buffer;
+    }
+  }
+
+  MeshletBuffer buildMeshlets(
+    const std::span<const uint32_t> indices,
+    const std::span<const IndexRange> ranges,
+    const std::span<const Position> positions,
+    const Options& options
+  ) {
+    if (options.maxVertices < 3 || options.maxVertices > 256 || options.maxTriangles < 1) {
+      throw InvalidOptions("Meshlet limits must allow 3 to 256 vertices and at least 1 triangle");
+    }
+
+    for (const auto& range : ranges) {
+      if (range.indexCount % 3 != 0) {
+        throw InvalidBody("Index range is not a whole number of triangles");
+      }
+      if (range.indexCount == 0) {
+        continue;
+      }
+
+      checkBounds(range.firstIndex, range.indexCount, indices.size(), "Index range is outside index buffer");
+      for (const auto index : indices.subspan(range.firstIndex, range.indexCount)) {
+        checkBounds(index, 1, positions.size(), "Vertex index is outside positions");
+      }
+    }
+
+    std::vector<MeshletBuffer> rangeBuffers(ranges.size());
+    parallelFor(ranges.size(), options.threadCount, [&](const size_t range) {
+      if (ranges[range].indexCount == 0) {
+        return;
+      }
+
+      rangeBuffers[range] = buildRange(
+        indices.subspan(ranges[range].firstIndex, ranges[range].indexCount),
+        positions,
+        options
+      );
+    });
+
+    // Then pack every range's meshlets one after another, rebasing their offsets
+    MeshletBuffer buffer;
+    size_t meshletCount = 0;
+    size_t vertexCount = 0;
+    size_t triangleBytes = 0;
+    for (const auto& rangeBuffer : rangeBuffers) {
+      meshletCount += rangeBuffer.meshlets.size();
+      vertexCount += rangeBuffer.vertices.size();
+      triangleBytes += rangeBuffer.triangles.size();
+    }
+    if (vertexCount > UINT32_MAX || triangleBytes > UINT32_MAX) {
+      throw OutOfBoundsAccess("Meshlet buffers are too large for 32 bit offsets");
+    }
+
+    buffer.meshlets.reserve(meshletCount);
+    buffer.bounds.reserve(meshletCount);
+    buffer.vertices.reserve(vertexCount);
+    buffer.triangles.reserve(triangleBytes);
+    buffer.ranges.reserve(ranges.size());
+
+    for (const auto& rangeBuffer : rangeBuffers) {
+      const auto vertexOffset = static_cast<uint32_t>(buffer.vertices.size());
+      const auto triangleOffset = static_cast<uint32_t>(buffer.triangles.size());
+
+      buffer.ranges.push_back(
+        {
+          .firstMeshlet = static_cast<uint32_t>(buffer.meshlets.size()),
+          .meshletCount = static_cast<uint32_t>(rangeBuffer.meshlets.size()),
+        }
+      );
+      for (auto meshlet : rangeBuffer.meshlets) {
+        meshlet.vertexOffset += vertexOffset;
+        meshlet.triangleOffset += triangleOffset;
+        buffer.meshlets.push_back(meshlet);
+      }
+
+      buffer.bounds.insert(buffer.bounds.end(), rangeBuffer.bounds.begin(), rangeBuffer.bounds.end());
+      buffer.vertices.insert(buffer.vertices.end(), rangeBuffer.vertices.begin(), rangeBuffer.vertices.end());
+      buffer.triangles.insert(buffer.triangles.end(), rangeBuffer.triangles.begin(), rangeBuffer.triangles.end());
+    }
+
+    return buffer;
+  }
+}
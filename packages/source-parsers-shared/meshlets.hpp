@@ -0,0 +1,138 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <span>
+#include <vector>
+#include "mesh-optimisation.hpp"
+
+/**
+ * Splitting of exported triangle lists into meshlets, the small clusters mesh shaders and GPU-driven culling work on.
+ */
+namespace SourceParsers::Meshlets {
+  using MeshOptimisation::IndexRange;
+  using MeshOptimisation::Position;
+
+  /**
+   * Limits on the size of each meshlet.
+   */
+  struct Options {
+    /**
+     * Most vertices a meshlet may reference, at most 256 so they can be indexed with a byte.
+     */
+    uint32_t maxVertices = 64;
+    /**
+     * Most triangles a meshlet may contain.
+     */
+    uint32_t maxTriangles = 124;
+    /**
+     * Number of threads to build ranges with. 0 uses the number of hardware threads.
+     */
+    unsigned int threadCount = 0;
+  };
+
+  struct Meshlet {
+    /**
+     * Index of the meshlet's first vertex in MeshletBuffer::vertices.
+     */
+    uint32_t vertexOffset;
+    /**
+     * Index of the meshlet's first triangle byte in MeshletBuffer::triangles, always a multiple of 4.
+     */
+    uint32_t triangleOffset;
+    uint32_t vertexCount;
+    uint32_t triangleCount;
+  };
+
+  /**
+   * Culling volumes of a meshlet.
+   */
+  struct MeshletBounds {
+    /**
+     * Centre of a sphere containing every vertex of the meshlet.
+     */
+    std::array<float, 3> center;
+    float radius;
+    /**
+     * Apex and axis of a cone containing the front facing normal of every triangle. The whole meshlet faces away from
+     * a camera, and can be culled, if dot(normalise(coneApex - cameraPosition), coneAxis) >= coneCutoff.
+     */
+    std::array<float, 3> coneApex;
+    std::array<float, 3> coneAxis;
+    /**
+     * Sine of the cone's half angle, or 1 if the normals are too spread out for the cone to cull anything.
+     */
+    float coneCutoff;
+  };
+
+  /**
+   * The meshlets of one input range.
+   */
+  struct MeshletRange {
+    uint32_t firstMeshlet;
+    uint32_t meshletCount;
+  };
+
+  /**
+   * Meshlets packed into flat buffers, ready to be uploaded to the GPU.
+   */
+  struct MeshletBuffer {
+    std::vector<Meshlet> meshlets;
+    /**
+     * Culling volumes, one for each meshlet.
+     */
+    std::vector<MeshletBounds> bounds;
+    /**
+     * Indices into the mesh's vertex buffer, in runs referenced by each meshlet.
+     */
+    std::vector<uint32_t> vertices;
+    /**
+     * Three indices into each meshlet's run of vertices for every triangle, with each meshlet's triangles padded to a
+     * multiple of 4 bytes.
+     */
+    std::vector<uint8_t> triangles;
+    /**
+     * Meshlets built from each input range, in the same order, so meshlets never span two ranges.
+     */
+    std::vector<MeshletRange> ranges;
+  };
+
+  /**
+   * Splits each range of a triangle list into meshlets, building ranges in parallel.
+   * @remark Triangles are added to meshlets in order, so running MeshOptimisation::optimiseVertexCache over each range
+   * @remark first gives meshlets which share more vertices.
+   * @param indices Triangle list containing every range, wound clockwise when seen from the front.
+   * @param ranges Ranges to split, such as one per material so no meshlet spans two materials.
+   * @param positions Position of every vertex the indices refer to.
+   * @param options Meshlet size limits.
+   * @return The packed meshlets.
+   * @throws Errors::InvalidOptions The options allow fewer than 3 vertices or 1 triangle, or more than 256 vertices.
+   * @throws Errors::InvalidBody A range is not a whole number of triangles.
+   * @throws Errors::OutOfBoundsAccess A range lies outside indices, or an index lies outside positions.
+   */
+  [[nodiscard]] MeshletBuffer buildMeshlets(
+    std::span<const uint32_t> indices,
+    std::span<const IndexRange> ranges,
+    std::span<const Position> positions,
+    const Options& options = {}
+  );
+
+  /**
+   * Same as the overload taking positions, for a vertex buffer whose vertices have a position member with x, y and z.
+   */
+  template<typename Vertex>
+  [[nodiscard]] MeshletBuffer buildMeshlets(
+    const std::span<const uint32_t> indices,
+    const std::span<const IndexRange> ranges,
+    const std::span<const Vertex> vertices,
+    const Options& options = {}
+  ) {
+    std::vector<Position> positions;
+    positions.reserve(vertices.size());
+    for (const auto& vertex : vertices) {
+      positions.push_back({ vertex.position.x, vertex.position.y, vertex.position.z });
+    }
+
+    return buildMeshlets(indices, ranges, std::span<const Position>(positions), options);
+  }
+}
@@ -0,0 +1,105 @@
+#include "vertex-quantisation.hpp"
+#include <algorithm>
+#include <cmath>
+#include <source-parsers-shared/internal/half-float.hpp>
+
+namespace SourceParsers::VertexQuantisation {
+  static_assert(sizeof(QuantisedVertex) == 20, "QuantisedVertex should be tightly packed");
+
+  namespace {
+    constexpr float SNORM16_MAX = 32767.f;
+    constexpr float UNORM16_MAX = 65535.f;
+
+    int16_t encodeSnorm16(const float value) {
+      return static_cast<int16_t>(std::lround(std::clamp(value, -1.f, 1.f) * SNORM16_MAX));
+    }
+
+    float decodeSnorm16(const int16_t value) {
+      return std::max(static_cast<float>(value) / SNORM16_MAX, -1.f);
+    }
+  }
+
+  uint16_t encodeHalf(const float value) {
+    return Internal::floatToHalf(value);
+  }
+
+  float decodeHalf(const uint16_t half) {
+    return Internal::halfToFloat(half);
+  }
+
+  std::array<int16_t, 2> encodeOctahedral(const std::array<float, 3>& direction) {
+    const auto length = std::abs(direction[0]) + std::abs(direction[1]) + std::abs(direction[2]);
+    if (length <= 0) {
+      return { 0, 0 };
+    }
+
+    auto x = direction[0] / length;
+    auto y = direction[1] / length;
+
+    // The lower hemisphere is folded over the diagonals onto the corners of the square
+    if (direction[2] < 0) {
+      const auto foldedX = (1 - std::abs(y)) * (x >= 0 ? 1.f : -1.f);
+      const auto foldedY = (1 - std::abs(x)) * (y >= 0 ? 1.f : -1.f);
+      x = foldedX;
+      y = foldedY;
+    }
+
+    return { encodeSnorm16(x), encodeSnorm16(y) };
+  }
+
+  std::array<float, 3> decodeOctahedral(const std::array<int16_t, 2>& encoded) {
+    auto x = decodeSnorm16(encoded[0]);
+    auto y = decodeSnorm16(encoded[1]);
+    const auto z = 1 - std::abs(x) - std::abs(y);
+
+    if (z < 0) {
+      const auto unfoldedX = (1 - std::abs(y)) * (x >= 0 ? 1.f : -1.f);
+      const auto unfoldedY = (1 - std::abs(x)) * (y >= 0 ? 1.f : -1.f);
+      x = unfoldedX;
+      y = unfoldedY;
+    }
+
+    const auto length = std::sqrt(x * x + y * y + z * z);
+    return { x / length, y / length, z / length };
+  }
+
+  std::array<uint16_t, 3> quantisePosition(const std::array<float, 3>& position, const PositionBounds& bounds) {
+    std::array<uint16_t, 3> quantised{};
+
+    for (size_t axis = 0; axis < 3; axis++) {
+      const auto extent = bounds.max[axis] - bounds.min[axis];
+      const auto normalised = extent > 0 ? (position[axis] - bounds.min[axis]) / extent : 0.f;
+
+      quantised[axis] = static_cast<uint16_t>(std::lround(std::clamp(normalised, 0.f, 1.f) * UNORM16_MAX));
+    }
+
+    return quantised;
+  }
+
+  std::array<float, 3> dequantisePosition(const std::array<uint16_t, 3>& quantised, const PositionBounds& bounds) {
+    std::array<float, 3> position{};
+
+    for (size_t axis = 0; axis < 3; axis++) {
+      const auto extent = bounds.max[axis] - bounds.min[axis];
+      position[axis] = bounds.min[axis] + static_cast<float>(quantised[axis]) / UNORM16_MAX * extent;
+    }
+
+    return position;
+  }
+
+  QuantisedVertex quantiseVertex(
+    const std::array<float, 3>& position,
+    const std::array<float, 3>& normal,
+    const std::array<float, 4>& tangent,
+    const std::array<float, 2>& uv,
+    const PositionBounds& bounds
+  ) {
+    return {
+      .position = quantisePosition(position, bounds),
+      .bitangentSign = static_cast<int16_t>(tangent[3] < 0 ? -1 : 1),
+      .normal = encodeOctahedral(normal),
+      .tangent = encodeOctahedral({ tangent[0], tangent[1], tangent[2] }),
+      .uv = { encodeHalf(uv[0]), encodeHalf(uv[1]) },
+    };
+  }
+}
@@ -0,0 +1,177 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <vector>
+
+/**
+ * Compact vertex encodings for exported meshes, to reduce GPU memory and upload bandwidth.
+ */
+namespace SourceParsers::VertexQuantisation {
+  /**
+   * Axis aligned box which quantised positions are relative to.
+   */
+  struct PositionBounds {
+    std::array<float, 3> min;
+    std::array<float, 3> max;
+  };
+
+  /**
+   * A vertex in 20 bytes, down from 48 to 64 for the full float vertices of the parsers.
+   */
+  struct QuantisedVertex {
+    /**
+     * Position as 16 bit unsigned normalised values spanning the mesh's PositionBounds.
+     */
+    std::array<uint16_t, 3> position;
+    /**
+     * Sign to multiply the cross product of normal and tangent by to get the bitangent, either 1 or -1.
+     */
+    int16_t bitangentSign;
+    /**
+     * Unit normal in octahedral encoding, as 16 bit signed normalised values.
+     */
+    std::array<int16_t, 2> normal;
+    /**
+     * Unit tangent in octahedral encoding, as 16 bit signed normalised values.
+     */
+    std::array<int16_t, 2> tangent;
+    /**
+     * Texture coordinates as half precision floats.
+     */
+    std::array<uint16_t, 2> uv;
+  };
+
+  /**
+   * Positions quantised against shared bounds, with the bounds needed to dequantise them.
+   */
+  struct QuantisedVertexBuffer {
+    PositionBounds bounds;
+    std::vector<QuantisedVertex> vertices;
+  };
+
+  /**
+   * Converts a float to the nearest half precision float, keeping infinities and NaNs.
+   * @param value
+   * @return Bits of the half precision float.
+   */
+  [[nodiscard]] uint16_t encodeHalf(float value);
+
+  /**
+   * Converts a half precision float back to a float.
+   * @param half Bits of the half precision float.
+   * @return
+   */
+  [[nodiscard]] float decodeHalf(uint16_t half);
+
+  /**
+   * Encodes a direction by projecting it onto an octahedron unfolded into a square.
+   * @param direction Direction, which does not need to be normalised. Zero vectors encode as +Z.
+   * @return 16 bit signed normalised coordinates on the square.
+   */
+  [[nodiscard]] std::array<int16_t, 2> encodeOctahedral(const std::array<float, 3>& direction);
+
+  /**
+   * Decodes a direction encoded by encodeOctahedral.
+   * @param encoded
+   * @return Unit direction.
+   */
+  [[nodiscard]] std::array<float, 3> decodeOctahedral(const std::array<int16_t, 2>& encoded);
+
+  /**
+   * Quantises a position to 16 bits per axis across bounds.
+   * @param position
+   * @param bounds Bounds to quantise relative to. Positions outside them are clamped.
+   * @return
+   */
+  [[nodiscard]] std::array<uint16_t, 3> quantisePosition(
+    const std::array<float, 3>& position,
+    const PositionBounds& bounds
+  );
+
+  /**
+   * Reverses quantisePosition, to within the bounds' extent divided by 65535 on each axis.
+   * @param quantised
+   * @param bounds Bounds the position was quantised relative to.
+   * @return
+   */
+  [[nodiscard]] std::array<float, 3> dequantisePosition(
+    const std::array<uint16_t, 3>& quantised,
+    const PositionBounds& bounds
+  );
+
+  /**
+   * Quantises every attribute of a vertex.
+   * @param position
+   * @param normal
+   * @param tangent Tangent direction, with the bitangent sign in w.
+   * @param uv
+   * @param bounds Bounds to quantise the position relative to.
+   * @return
+   */
+  [[nodiscard]] QuantisedVertex quantiseVertex(
+    const std::array<float, 3>& position,
+    const std::array<float, 3>& normal,
+    const std::array<float, 4>& tangent,
+    const std::array<float, 2>& uv,
+    const PositionBounds& bounds
+  );
+
+  /**
+   * Gets the smallest bounds containing every vertex.
+   * @param vertices Vertices with a position member with x, y and z.
+   * @return Bounds, or zero sized bounds at the origin if there are no vertices.
+   */
+  template<typename Vertex>
+  [[nodiscard]] PositionBounds computeBounds(const std::span<const Vertex> vertices) {
+    if (vertices.empty()) {
+      return { .min = { 0, 0, 0 }, .max = { 0, 0, 0 } };
+    }
+
+    const auto& first = vertices.front().position;
+    PositionBounds bounds{ .min = { first.x, first.y, first.z }, .max = { first.x, first.y, first.z } };
+
+    for (const auto& vertex : vertices) {
+      const std::array position{ vertex.position.x, vertex.position.y, vertex.position.z };
+
+      for (size_t axis = 0; axis < 3; axis++) {
+        bounds.min[axis] = position[axis] < bounds.min[axis] ? position[axis] : bounds.min[axis];
+        bounds.max[axis] = position[axis] > bounds.max[axis] ? position[axis] : bounds.max[axis];
+      }
+    }
+
+    return bounds;
+  }
+
+  /**
+   * Quantises a vertex buffer.
+   * @param vertices Vertices with position, normal, tangent (with w) and uv members.
+   * @param bounds Bounds to quantise positions relative to, such as ones shared by every mesh in a scene, or empty to
+   * use the vertices' own bounds for the best precision.
+   * @return The quantised vertices, in the same order, and the bounds used.
+   */
+  template<typename Vertex>
+  [[nodiscard]] QuantisedVertexBuffer quantiseVertexBuffer(
+    const std::span<const Vertex> vertices,
+    const std::optional<PositionBounds>& bounds = std::nullopt
+  ) {
+    QuantisedVertexBuffer buffer{ .bounds = bounds.has_value() ? *bounds : computeBounds(vertices), .vertices = {} };
+    buffer.vertices.reserve(vertices.size());
+
+    for (const auto& vertex : vertices) {
+      buffer.vertices.push_back(
+        quantiseVertex(
+          { vertex.position.x, vertex.position.y, vertex.position.z },
+          { vertex.normal.x, vertex.normal.y, vertex.normal.z },
+          { vertex.tangent.x, vertex.tangent.y, vertex.tangent.z, vertex.tangent.w },
+          { vertex.uv.x, vertex.uv.y },
+          buffer.bounds
+        )
+      );
+    }
+
+    return buffer;
+  }
+}
@@ -0,0 +1,52 @@
+#include "batch.hpp"
+#include <source-parsers-shared/internal/parallel-for.hpp>
+#include "vdf.hpp"
+
+namespace VdfParser {
+  using namespace SourceParsers::Internal;
+
+  namespace {
+    BatchParseResult parseCapturingErrors(const std::string& raw) {
+      try {
+        return { .keyValues = fromString(raw), .error = std::nullopt };
+      } catch (const Errors::Error& error) {
+        return {
+          .keyValues = std::nullopt,
+          .error = BatchParseError{ .reason = error.getReason(), .message = error.what() },
+        };
+      }
+    }
+  }
+
+  std::vector<BatchParseResult> fromStrings(const std::span<const std::string> raws, const unsigned int threadCount) {
+    std::vector<BatchParseResult> results(raws.size());
+
+    parallelFor(
+      raws.size(),
+      threadCount,
+      [&raws, &results](const size_t index) {
+        results[index] = parseCapturingErrors(raws[index]);
+      }
+    );
+
+    return results;
+  }
+
+  std::vector<BatchParseResult> fromSources(
+    const size_t count,
+    const std::function<std::string(size_t index)>& loader,
+    const unsigned int threadCount
+  ) {
+    std::vector<BatchParseResult> results(count);
+
+    parallelFor(
+      count,
+      threadCount,
+      [&loader, &results](const size_t index) {
+        results[index] = parseCapturingErrors(loader(index));
+      }
+    );
+
+    return results;
+  }
+}
@@ -0,0 +1,65 @@
+#pragma once
+
+#include <functional>
+#include <optional>
+#include <span>
+#include <string>
+#include <vector>
+#include "errors.hpp"
+#include "keyvalue.hpp"
+
+namespace VdfParser {
+  /**
+   * Describes why a single entry in a batch failed to parse.
+   */
+  struct BatchParseError {
+    /**
+     * Reason reported by the Errors::Error thrown while parsing.
+     */
+    Errors::Reason reason;
+
+    /**
+     * Human readable description of the error.
+     */
+    std::string message;
+  };
+
+  /**
+   * Outcome of parsing a single entry in a batch. Exactly one of keyValues and error is set.
+   */
+  struct BatchParseResult {
+    /**
+     * Parsed key-values, or std::nullopt if the entry failed to parse.
+     */
+    std::optional<KeyValue> keyValues;
+
+    /**
+     * Error describing why the entry failed to parse, or std::nullopt on success.
+     */
+    std::optional<BatchParseError> error;
+  };
+
+  /**
+   * Parses many VDF strings at once across a pool of worker threads.
+   * A parse error in one entry is reported in its result and does not affect the others.
+   * @param raws Raw VDF key-value data for each entry.
+   * @param threadCount Number of worker threads to use, or 0 for one per hardware thread.
+   * @return One result per entry, in the same order as raws.
+   */
+  [[nodiscard]] std::vector<BatchParseResult> fromStrings(std::span<const std::string> raws, unsigned int threadCount = 0);
+
+  /**
+   * Loads and parses many VDF sources at once across a pool of worker threads.
+   * The loader runs on the worker threads, so reading files (from disk, a VPK, etc.) is parallelised along with parsing.
+   * @remark Exceptions thrown by the loader are not captured per entry. The first is rethrown once all workers stop.
+   * @param count Number of sources to parse.
+   * @param loader Thread-safe function returning the raw VDF data for the source at the given index.
+   * @param threadCount Number of worker threads to use, or 0 for one per hardware thread.
+   * @return One result per source, ordered by index.
+   */
+  [[nodiscard]] std::vector<BatchParseResult> fromSources(
+    size_t count,
+    const std::function<std::string(size_t index)>& loader,
+    unsigned int threadCount = 0
+  );
+}
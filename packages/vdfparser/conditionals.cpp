@@ -0,0 +1,172 @@
+#include "conditionals.hpp"
+#include <algorithm>
+#include <cctype>
+#include "errors.hpp"
+
+namespace VdfParser {
+  namespace {
+    constexpr uint64_t FNV_OFFSET_BASIS = 0xcbf29ce484222325;
+    constexpr uint64_t FNV_PRIME = 0x100000001b3;
+
+    std::string_view trim(std::string_view text) {
+      while (!text.empty() && std::isspace(static_cast<unsigned char>(text.front()))) {
+        text.remove_prefix(1);
+      }
+      while (!text.empty() && std::isspace(static_cast<unsigned char>(text.back()))) {
+        text.remove_suffix(1);
+      }
+
+      return text;
+    }
+
+    std::string toLowercase(const std::string_view text) {
+      std::string lowercase(text);
+      std::ranges::transform(
+        lowercase,
+        lowercase.begin(),
+        [](const unsigned char c) {
+          return static_cast<char>(std::tolower(c));
+        }
+      );
+
+      return lowercase;
+    }
+
+    /**
+     * Removes the text before the next separator, or all of it if there is none, along with the separator.
+     * @param text Text to take from.
+     * @param separator
+     * @param part Set to the removed text, without the separator.
+     * @return True if a separator was found, so another part follows.
+     */
+    bool takeUntil(std::string_view& text, const std::string_view separator, std::string_view& part) {
+      const auto position = text.find(separator);
+      part = text.substr(0, position);
+      if (position == std::string_view::npos) {
+        text = {};
+        return false;
+      }
+
+      text.remove_prefix(position + separator.size());
+      return true;
+    }
+  }
+
+  ConditionalSymbols::ConditionalSymbols(const std::span<const std::string> definedSymbols) {
+    for (const auto& symbol : definedSymbols) {
+      if (findSymbolBit(symbol) != MAX_SYMBOLS) {
+        continue;
+      }
+
+      if (symbolNames.size() >= MAX_SYMBOLS) {
+        throw Errors::TooManySymbols("Too many conditional symbols defined");
+      }
+
+      definedMask |= uint64_t{ 1 } << symbolNames.size();
+      symbolNames.push_back(toLowercase(symbol));
+    }
+
+    auto sortedSymbols = symbolNames;
+    std::ranges::sort(sortedSymbols);
+
+    fingerprint = FNV_OFFSET_BASIS;
+    for (const auto& symbol : sortedSymbols) {
+      // Hash the terminator too so {"AB"} and {"A", "B"} differ
+      for (const auto c : std::string_view(symbol.c_str(), symbol.size() + 1)) {
+        fingerprint ^= static_cast<uint8_t>(c);
+        fingerprint *= FNV_PRIME;
+      }
+    }
+  }
+
+  size_t ConditionalSymbols::findSymbolBit(const std::string_view symbol) const {
+    // There are only a handful of symbols, so a linear scan beats hashing and needs no allocation
+    for (size_t bit = 0; bit < symbolNames.size(); bit++) {
+      if (std::ranges::equal(
+            symbolNames[bit],
+            symbol,
+            [](const unsigned char a, const unsigned char b) {
+              return a == std::tolower(b);
+            }
+          )) {
+        return bit;
+      }
+    }
+
+    return MAX_SYMBOLS;
+  }
+
+  CompiledConditional::Term ConditionalSymbols::compileTerm(std::string_view alternative) const {
+    CompiledConditional::Term term;
+
+    for (auto hasNext = true; hasNext;) {
+      std::string_view operand;
+      hasNext = takeUntil(alternative, "&&", operand);
+      operand = trim(operand);
+
+      const auto negated = operand.starts_with('!');
+      if (negated) {
+        operand = trim(operand.substr(1));
+      }
+      if (operand.starts_with('$')) {
+        operand.remove_prefix(1);
+      }
+
+      const auto bit = findSymbolBit(operand);
+      if (bit == MAX_SYMBOLS) {
+        // Undefined symbols are false, so only matter when required
+        term.satisfiable = term.satisfiable && negated;
+        continue;
+      }
+
+      if (negated) {
+        term.forbidden |= uint64_t{ 1 } << bit;
+      } else {
+        term.required |= uint64_t{ 1 } << bit;
+      }
+    }
+
+    return term;
+  }
+
+  bool ConditionalSymbols::passes(const CompiledConditional::Term& term) const {
+    return term.satisfiable && (definedMask & term.required) == term.required && (definedMask & term.forbidden) == 0;
+  }
+
+  CompiledConditional ConditionalSymbols::compile(std::string_view conditional) const {
+    CompiledConditional compiled;
+
+    for (auto hasNext = true; hasNext;) {
+      std::string_view alternative;
+      hasNext = takeUntil(conditional, "||", alternative);
+      compiled.terms.push_back(compileTerm(alternative));
+    }
+
+    return compiled;
+  }
+
+  bool ConditionalSymbols::evaluate(const CompiledConditional& conditional) const {
+    return std::ranges::any_of(
+      conditional.terms,
+      [this](const CompiledConditional::Term& term) {
+        return passes(term);
+      }
+    );
+  }
+
+  bool ConditionalSymbols::evaluate(std::string_view conditional) const {
+    for (auto hasNext = true; hasNext;) {
+      std::string_view alternative;
+      hasNext = takeUntil(conditional, "||", alternative);
+      if (passes(compileTerm(alternative))) {
+        return true;
+      }
+    }
+
+    return false;
+  }
+
+  uint64_t ConditionalSymbols::getFingerprint() const {
+    return fingerprint;
+  }
+}
@@ -0,0 +1,101 @@
+#pragma once
+
+#include <cstdint>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace VdfParser {
+  /**
+   * A conditional tag (e.g. [$WIN32] or [!$X360||$PS3]) compiled against a ConditionalSymbols instance.
+   * Stored as a list of alternatives (joined by ||), each requiring some symbols to be defined and others not to be.
+   */
+  struct CompiledConditional {
+    struct Term {
+      /**
+       * Bits of the symbols which must be defined.
+       */
+      uint64_t required = 0;
+      /**
+       * Bits of the symbols which must not be defined.
+       */
+      uint64_t forbidden = 0;
+      /**
+       * False if the term requires a symbol which isn't defined, meaning it can never pass.
+       */
+      bool satisfiable = true;
+    };
+
+    std::vector<Term> terms;
+  };
+
+  /**
+   * The set of symbols (e.g. WIN32, X360, POSIX) defined when evaluating conditional tags in KeyValues.
+   * Symbols are assigned bits once on construction, so evaluating a compiled conditional is a mask test.
+   * Symbol names are case-insensitive and given without the leading $.
+   */
+  class ConditionalSymbols {
+  public:
+    /**
+     * Maximum number of symbols which can be defined at once.
+     */
+    static constexpr size_t MAX_SYMBOLS = 64;
+
+    /**
+     * Creates a symbol set where exactly the given symbols are defined.
+     * @param definedSymbols Names of the defined symbols, without the leading $.
+     * @throws Errors::TooManySymbols More than MAX_SYMBOLS symbols were given.
+     */
+    explicit ConditionalSymbols(std::span<const std::string> definedSymbols);
+
+    /**
+     * Compiles the contents of a conditional tag, without the surrounding brackets.
+     * Supports $SYMBOL, !$SYMBOL, && and ||, where && binds tighter than ||.
+     * @param conditional Conditional text, e.g. "!$X360&&$WIN32".
+     * @return Compiled conditional for use with evaluate.
+     */
+    [[nodiscard]] CompiledConditional compile(std::string_view conditional) const;
+
+    /**
+     * Tests a compiled conditional against the defined symbols.
+     * @param conditional Conditional compiled by this instance.
+     * @return True if the conditional passes.
+     */
+    [[nodiscard]] bool evaluate(const CompiledConditional& conditional) const;
+
+    /**
+     * Compiles and tests a conditional in one step, compiling each alternative straight into masks without allocating.
+     * @param conditional Conditional text, e.g. "!$X360&&$WIN32".
+     * @return True if the conditional passes.
+     */
+    [[nodiscard]] bool evaluate(std::string_view conditional) const;
+
+    /**
+     * Gets a hash identifying the defined symbols, independent of the order and case they were given in.
+     * @return Hash of the defined symbols.
+     */
+    [[nodiscard]] uint64_t getFingerprint() const;
+
+  private:
+    /**
+     * Compiles one alternative of a conditional, the operands between two ||.
+     */
+    [[nodiscard]] CompiledConditional::Term compileTerm(std::string_view alternative) const;
+
+    [[nodiscard]] bool passes(const CompiledConditional::Term& term) const;
+
+    /**
+     * Finds the bit of a symbol, ignoring case.
+     * @return The symbol's bit, or MAX_SYMBOLS if it is not defined.
+     */
+    [[nodiscard]] size_t findSymbolBit(std::string_view symbol) const;
+
+    /**
+     * Lowercase names of the defined symbols, indexed by their bit.
+     */
+    std::vector<std::string> symbolNames;
+    uint64_t definedMask = 0;
+    uint64_t fingerprint = 0;
+  };
+}
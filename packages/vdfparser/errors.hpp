@@ -11,7 +11,12 @@ explicit reason(const char* message) : Error(Reason::reason, message) {} \
 
 namespace VdfParser::Errors {
   enum class Reason : uint8_t {
-    UnexpectedCharacter
+    UnexpectedCharacter,
+    UnrepresentableValue,
+    BufferTooSmall,
+    UnresolvedInclude,
+    IncludeCycle,
+    TooManySymbols
   };
 
   class Error : public std::runtime_error {
@@ -27,6 +32,16 @@ namespace VdfParser::Errors {
   };
 
   ERROR_FOR_REASON(UnexpectedCharacter);
+
+  ERROR_FOR_REASON(UnrepresentableValue);
+
+  ERROR_FOR_REASON(BufferTooSmall);
+
+  ERROR_FOR_REASON(UnresolvedInclude);
+
+  ERROR_FOR_REASON(IncludeCycle);
+
+  ERROR_FOR_REASON(TooManySymbols);
 }
 
 #undef ERROR_FOR_REASON
@@ -1,8 +1,195 @@
 #include "keyvalue.hpp"
+#include <algorithm>
+#include <array>
+#include <cctype>
+#include <charconv>
+#include <cmath>
+#include <string_view>
 
 namespace VdfParser {
   using namespace SourceParsers::Internal;
 
+  namespace {
+    constexpr std::string_view WHITESPACE = " \t\r\n";
+
+    std::string_view trim(std::string_view text) {
+      const auto first = text.find_first_not_of(WHITESPACE);
+      if (first == std::string_view::npos) {
+        return {};
+      }
+
+      return text.substr(first, text.find_last_not_of(WHITESPACE) - first + 1);
+    }
+
+    /**
+     * Parses a float which must span the whole of text (after trimming).
+     */
+    std::optional<float> parseFloat(std::string_view text) {
+      text = trim(text);
+      if (text.starts_with('+')) {
+        text.remove_prefix(1);
+      }
+
+      float value;
+      const auto [end, error] = std::from_chars(text.data(), text.data() + text.size(), value);
+      if (error != std::errc{} || end != text.data() + text.size()) {
+        return std::nullopt;
+      }
+
+      return value;
+    }
+
+    std::optional<int32_t> parseInt(std::string_view text) {
+      text = trim(text);
+      if (text.starts_with('+')) {
+        text.remove_prefix(1);
+      }
+
+      int32_t value;
+      const auto [end, error] = std::from_chars(text.data(), text.data() + text.size(), value);
+      if (error == std::errc{} && end == text.data() + text.size()) {
+        return value;
+      }
+
+      // Fall back to truncating values written with a fractional part or exponent, e.g. "1.0"
+      const auto number = parseFloat(text);
+      if (!number.has_value() || !std::isfinite(*number) || std::abs(*number) >= 2147483648.f) {
+        return std::nullopt;
+      }
+
+      return static_cast<int32_t>(*number);
+    }
+
+    std::optional<bool> parseBool(std::string_view text) {
+      text = trim(text);
+
+      const auto equalsIgnoringCase = [text](const std::string_view other) {
+        return std::ranges::equal(
+          text,
+          other,
+          [](const unsigned char a, const unsigned char b) {
+            return std::tolower(a) == std::tolower(b);
+          }
+        );
+      };
+
+      if (equalsIgnoringCase("true")) {
+        return true;
+      }
+      if (equalsIgnoringCase("false")) {
+        return false;
+      }
+
+      const auto number = parseFloat(text);
+      return number.has_value() ? std::make_optional(*number != 0.f) : std::nullopt;
+    }
+
+    /**
+     * Splits a vector-like string into up to four numbers, returning how many were read, or 0 on failure.
+     * @param text Text to parse, with any brackets already removed.
+     * @param components Destination for the parsed numbers.
+     */
+    size_t parseComponents(std::string_view text, std::array<float, 4>& components) {
+      size_t count = 0;
+
+      while (true) {
+        text = trim(text);
+        if (text.empty()) {
+          return count;
+        }
+
+        if (count == components.size()) {
+          return 0;
+        }
+
+        const auto tokenEnd = std::min(text.find_first_of(WHITESPACE), text.size());
+        const auto component = parseFloat(text.substr(0, tokenEnd));
+        if (!component.has_value()) {
+          return 0;
+        }
+
+        components[count++] = *component;
+        text.remove_prefix(tokenEnd);
+      }
+    }
+
+    enum class Bracket : uint8_t { None, Square, Curly };
+
+    /**
+     * Removes the surrounding [] or {} from text, returning which kind was found.
+     */
+    std::optional<Bracket> stripBrackets(std::string_view& text) {
+      text = trim(text);
+
+      if (text.starts_with('[') || text.starts_with('{')) {
+        const auto bracket = text.front() == '[' ? Bracket::Square : Bracket::Curly;
+        if (!text.ends_with(bracket == Bracket::Square ? ']' : '}')) {
+          return std::nullopt;
+        }
+
+        text = text.substr(1, text.size() - 2);
+        return bracket;
+      }
+
+      return Bracket::None;
+    }
+
+    std::optional<Vector3> parseVector(std::string_view text) {
+      const auto bracket = stripBrackets(text);
+      if (!bracket.has_value()) {
+        return std::nullopt;
+      }
+
+      std::array<float, 4> components{};
+      const auto count = parseComponents(text, components);
+      if (count != 1 && count != 3) {
+        return std::nullopt;
+      }
+
+      if (count == 1) {
+        components[1] = components[2] = components[0];
+      }
+
+      const auto scale = bracket == Bracket::Curly ? 1.f / 255.f : 1.f;
+      return Vector3{ .x = components[0] * scale, .y = components[1] * scale, .z = components[2] * scale };
+    }
+
+    std::optional<Colour> parseColour(std::string_view text) {
+      const auto bracket = stripBrackets(text);
+      if (!bracket.has_value()) {
+        return std::nullopt;
+      }
+
+      std::array<float, 4> components{};
+      const auto count = parseComponents(text, components);
+      if (count != 3 && count != 4) {
+        return std::nullopt;
+      }
+
+      const auto scale = bracket == Bracket::Square ? 255.f : 1.f;
+      if (count == 3) {
+        components[3] = 255.f / scale;
+      }
+
+      const auto toByte = [scale](const float component) {
+        return static_cast<uint8_t>(std::clamp(std::round(component * scale), 0.f, 255.f));
+      };
+
+      return Colour{
+        .r = toByte(components[0]),
+        .g = toByte(components[1]),
+        .b = toByte(components[2]),
+        .a = toByte(components[3]),
+      };
+    }
+
+    template<typename T>
+    std::optional<T> parseValue(const KeyValue& keyValue, std::optional<T> (*parse)(std::string_view)) {
+      const auto* value = std::get_if<std::string>(&keyValue.value);
+      return value != nullptr ? parse(*value) : std::nullopt;
+    }
+  }
+
   std::optional<CaseInsensitiveMap<KeyValue>> KeyValue::getChildren() const {
     if (!std::holds_alternative<CaseInsensitiveMap<KeyValue>>(value)) {
       return std::nullopt;
@@ -12,21 +199,22 @@ namespace VdfParser {
   }
 
   std::optional<KeyValue> KeyValue::getChild(const std::string& key) const {
-    const auto& children = getChildren();
-    if (!children.has_value()) {
-      return std::nullopt;
+    const auto* child = findChild(key);
+    return child != nullptr ? std::make_optional(*child) : std::nullopt;
+  }
+
+  const KeyValue* KeyValue::findChild(const std::string& key) const {
+    const auto* children = std::get_if<CaseInsensitiveMap<KeyValue>>(&value);
+    if (children == nullptr) {
+      return nullptr;
     }
 
-    return children->contains(key) ? std::make_optional(children->at(key)) : std::nullopt;
+    const auto child = children->find(key);
+    return child != children->end() ? &child->second : nullptr;
   }
 
   bool KeyValue::hasChild(const std::string& key) const {
-    const auto& children = getChildren();
-    if (!children.has_value()) {
-      return false;
-    }
-
-    return children->contains(key);
+    return findChild(key) != nullptr;
   }
 
   std::optional<std::string> KeyValue::getValue() const {
@@ -34,15 +222,35 @@ namespace VdfParser {
   }
 
   std::optional<std::string> KeyValue::getNestedValue(const std::vector<std::string>& path) const {
-    std::optional node = *this;
+    const auto* node = this;
 
     for (const auto& key : path) {
-      node = node->getChild(key);
-      if (!node.has_value()) {
+      node = node->findChild(key);
+      if (node == nullptr) {
         return std::nullopt;
       }
     }
 
     return node->getValue();
   }
+
+  std::optional<int32_t> KeyValue::getInt() const {
+    return parseValue(*this, parseInt);
+  }
+
+  std::optional<float> KeyValue::getFloat() const {
+    return parseValue(*this, parseFloat);
+  }
+
+  std::optional<bool> KeyValue::getBool() const {
+    return parseValue(*this, parseBool);
+  }
+
+  std::optional<Vector3> KeyValue::getVector() const {
+    return parseValue(*this, parseVector);
+  }
+
+  std::optional<Colour> KeyValue::getColour() const {
+    return parseValue(*this, parseColour);
+  }
 }
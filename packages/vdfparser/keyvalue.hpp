@@ -1,5 +1,6 @@
 #pragma once
 
+#include <cstdint>
 #include <optional>
 #include <string>
 #include <variant>
@@ -7,6 +8,20 @@
 #include <source-parsers-shared/internal/case-insensitive-map.hpp>
 
 namespace VdfParser {
+  /**
+   * Three component vector, as used by material parameters such as $color or $envmaptint.
+   */
+  struct Vector3 {
+    float x, y, z;
+  };
+
+  /**
+   * 8-bit per channel RGBA colour.
+   */
+  struct Colour {
+    uint8_t r, g, b, a;
+  };
+
   /**
    * Abstraction over an entry in the VDF key-value structure.
    * May represent either a primitive string value, or a complex object.
@@ -33,6 +48,15 @@ namespace VdfParser {
      */
     [[nodiscard]] std::optional<KeyValue> getChild(const std::string& key) const;
 
+    /**
+     * Returns a pointer to the KeyValue at the given key without copying it,
+     * or nullptr if the key doesn't exist or this isn't an object value.
+     * @remark Prefer this over getChild for repeated reads, as the child is not copied.
+     * @param key Key to read.
+     * @return Pointer to the child, valid until this object is modified.
+     */
+    [[nodiscard]] const KeyValue* findChild(const std::string& key) const;
+
     /**
      * Returns whether a value exists at the give key.
      * @param key Key to check.
@@ -52,5 +76,38 @@ namespace VdfParser {
      * @return Value of the final key in the path.
      */
     [[nodiscard]] std::optional<std::string> getNestedValue(const std::vector<std::string>& path) const;
+
+    /**
+     * Parses the value as a base 10 integer, ignoring surrounding whitespace and any trailing fractional part.
+     * @return Integer value, or std::nullopt if this is an object or the value is not numeric.
+     */
+    [[nodiscard]] std::optional<int32_t> getInt() const;
+
+    /**
+     * Parses the value as a floating point number, ignoring surrounding whitespace.
+     * @return Float value, or std::nullopt if this is an object or the value is not numeric.
+     */
+    [[nodiscard]] std::optional<float> getFloat() const;
+
+    /**
+     * Parses the value as a boolean, accepting "true"/"false" (case-insensitive) or any number, where non-zero is true.
+     * @return Boolean value, or std::nullopt if this is an object or the value is neither a boolean nor numeric.
+     */
+    [[nodiscard]] std::optional<bool> getBool() const;
+
+    /**
+     * Parses the value as a vector, following the conventions of material parameters:
+     * "[x y z]" and "x y z" are read as-is, "{r g b}" is read as 0-255 and scaled to 0-1,
+     * and a single number is used for all three components.
+     * @return Vector value, or std::nullopt if this is an object or the value is not a vector.
+     */
+    [[nodiscard]] std::optional<Vector3> getVector() const;
+
+    /**
+     * Parses the value as an RGB or RGBA colour, where a missing alpha is 255:
+     * "{r g b}" and "r g b a" are read as 0-255, while "[r g b]" is read as 0-1 and scaled to 0-255.
+     * @return Colour value, or std::nullopt if this is an object or the value is not a colour.
+     */
+    [[nodiscard]] std::optional<Colour> getColour() const;
   };
 }
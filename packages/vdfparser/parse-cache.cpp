@@ -0,0 +1,59 @@
+#include "parse-cache.hpp"
+
+namespace VdfParser {
+  namespace {
+    constexpr uint64_t FNV_OFFSET_BASIS = 0xcbf29ce484222325;
+    constexpr uint64_t FNV_PRIME = 0x100000001b3;
+
+    uint64_t hashContents(const std::string_view raw) {
+      auto hash = FNV_OFFSET_BASIS;
+      for (const auto c : raw) {
+        hash ^= static_cast<uint8_t>(c);
+        hash *= FNV_PRIME;
+      }
+
+      return hash;
+    }
+  }
+
+  size_t ParseCache::KeyHasher::operator()(const Key& key) const noexcept {
+    return static_cast<size_t>(key.hash ^ (key.length * FNV_PRIME) ^ key.optionsFingerprint);
+  }
+
+  std::shared_ptr<const Internal::ParsedDocument> ParseCache::getOrParse(
+    const std::string_view raw,
+    const uint64_t optionsFingerprint,
+    const std::function<Internal::ParsedDocument()>& parse
+  ) {
+    const Key key{ .hash = hashContents(raw), .length = raw.size(), .optionsFingerprint = optionsFingerprint };
+
+    {
+      const std::lock_guard lock(mutex);
+      if (const auto it = documents.find(key); it != documents.end() && it->second.raw == raw) {
+        return it->second.document;
+      }
+    }
+
+    // Parse outside the lock so other threads aren't blocked, accepting that two threads may race to parse the same file
+    auto document = std::make_shared<const Internal::ParsedDocument>(parse());
+
+    const std::lock_guard lock(mutex);
+    const auto [it, inserted] = documents.try_emplace(key, Entry{ .raw = std::string(raw), .document = document });
+    if (!inserted && it->second.raw != raw) {
+      // Another document with the same hash is already cached, so this one is returned without being cached
+      return document;
+    }
+
+    return it->second.document;
+  }
+
+  size_t ParseCache::size() const {
+    const std::lock_guard lock(mutex);
+    return documents.size();
+  }
+
+  void ParseCache::clear() {
+    const std::lock_guard lock(mutex);
+    documents.clear();
+  }
+}
@@ -0,0 +1,89 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+#include "keyvalue.hpp"
+
+namespace VdfParser {
+  namespace Internal {
+    /**
+     * An #include or #base directive found at the top level of a document.
+     */
+    struct Directive {
+      enum class Type : uint8_t { Include, Base };
+
+      Type type;
+      std::string path;
+    };
+
+    /**
+     * A document parsed without resolving its directives, so it can be shared between every file that includes it.
+     */
+    struct ParsedDocument {
+      KeyValue keyValues;
+      std::vector<Directive> directives;
+    };
+  }
+
+  /**
+   * Thread-safe cache of parsed documents keyed by a hash of their contents, which are compared in full on a hit.
+   * Pass the same cache to every fromString call that resolves includes,
+   * so shared base files (e.g. clientscheme.res) are parsed once no matter how many files include them.
+   */
+  class ParseCache {
+  public:
+    /**
+     * Returns the cached parse of raw, calling parse to populate the cache on a miss.
+     * @param raw Raw VDF data used to compute the cache key.
+     * @param optionsFingerprint Identifies any options which change the parse result (e.g. conditional symbols).
+     * @param parse Function to parse raw if it is not already cached.
+     * @return Shared, immutable parsed document.
+     */
+    [[nodiscard]] std::shared_ptr<const Internal::ParsedDocument> getOrParse(
+      std::string_view raw,
+      uint64_t optionsFingerprint,
+      const std::function<Internal::ParsedDocument()>& parse
+    );
+
+    /**
+     * Gets the number of documents in the cache.
+     * @return Number of cached documents.
+     */
+    [[nodiscard]] size_t size() const;
+
+    /**
+     * Removes all documents from the cache. Documents still referenced elsewhere are kept alive until released.
+     */
+    void clear();
+
+  private:
+    struct Key {
+      uint64_t hash;
+      size_t length;
+      uint64_t optionsFingerprint;
+
+      bool operator==(const Key&) const = default;
+    };
+
+    struct KeyHasher {
+      size_t operator()(const Key& key) const noexcept;
+    };
+
+    struct Entry {
+      /**
+       * Raw data the document was parsed from, compared on every hit so a hash collision is never mistaken for a match.
+       */
+      std::string raw;
+      std::shared_ptr<const Internal::ParsedDocument> document;
+    };
+
+    mutable std::mutex mutex;
+    std::unordered_map<Key, Entry, KeyHasher> documents;
+  };
+}
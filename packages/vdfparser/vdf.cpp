@@ -1,14 +1,28 @@
 #include "vdf.hpp"
+#include <algorithm>
+#include <memory>
 #include <set>
 #include <source-parsers-shared/internal/peekable-stream.hpp>
 #include "errors.hpp"
 
 namespace VdfParser {
   using namespace SourceParsers::Internal;
+  using Internal::Directive;
+  using Internal::ParsedDocument;
 
   namespace {
     const std::set WHITESPACE = { ' ', '\t', '\r', '\n' };
 
+    /**
+     * Maximum depth of nested includes, which also catches cycles through differently spelled paths.
+     */
+    constexpr size_t MAX_INCLUDE_DEPTH = 32;
+
+    const CaseInsensitiveMap<Directive::Type> DIRECTIVES = {
+      { "#include", Directive::Type::Include },
+      { "#base", Directive::Type::Base },
+    };
+
     std::string parseLiteral(PeekableStream& stream) {
       std::set<char> terminators;
       auto isQuoted = false;
@@ -56,7 +70,51 @@ namespace VdfParser {
       }
     }
 
-    CaseInsensitiveMap<KeyValue> parseKeyValues(PeekableStream& stream) {
+    bool isConditionalStart(const PeekableStream& stream) {
+      const auto next = stream.peek(3);
+      return next.starts_with("[$") || next.starts_with("[!$");
+    }
+
+    /**
+     * Consumes a conditional tag if one is next in the stream, returning whether it passes.
+     * @param stream Stream to parse from.
+     * @param symbols Symbols to evaluate the conditional with. If null, every conditional passes.
+     * @return False if a conditional was found and it failed, true otherwise.
+     */
+    bool consumeConditional(PeekableStream& stream, const ConditionalSymbols* symbols) {
+      if (!isConditionalStart(stream)) {
+        return true;
+      }
+
+      stream.discard();
+      const auto conditional = stream.consumeWhile(
+        [](const char c) {
+          return c != ']' && c != '\0';
+        }
+      );
+
+      if (stream.peek() != ']') {
+        throw Errors::UnexpectedCharacter("Expected ']' to close conditional");
+      }
+
+      stream.discard();
+      discardWhitespaceAndComments(stream);
+
+      return symbols == nullptr || symbols->evaluate(conditional);
+    }
+
+    /**
+     * Parses key-values until the end of the current block.
+     * @param stream Stream to parse from.
+     * @param symbols Symbols to evaluate conditionals with. If null, conditionals are parsed but ignored.
+     * @param directives If non-null, top-level #include and #base directives are moved here instead of being parsed as keys.
+     * @return Parsed key-values.
+     */
+    CaseInsensitiveMap<KeyValue> parseKeyValues(
+      PeekableStream& stream,
+      const ConditionalSymbols* symbols,
+      std::vector<Directive>* directives
+    ) {
       CaseInsensitiveMap<KeyValue> values;
 
       while (!stream.empty() && stream.peek() != '}') {
@@ -64,13 +122,20 @@ namespace VdfParser {
 
         discardWhitespaceAndComments(stream);
 
+        if (stream.empty() || stream.peek() == '}') {
+          break;
+        }
+
         auto key = parseLiteral(stream);
 
         discardWhitespaceAndComments(stream);
 
+        // Conditionals on blocks come between the key and the opening brace, and on values after the value
+        auto isIncluded = consumeConditional(stream, symbols);
+
         if (stream.peek() == '{') {
           stream.discard();
-          keyValue.value = parseKeyValues(stream);
+          keyValue.value = parseKeyValues(stream, symbols, nullptr);
 
           if (stream.peek() != '}') {
             throw Errors::UnexpectedCharacter("Expected '}' to close key-value block");
@@ -79,19 +144,131 @@ namespace VdfParser {
           stream.discard();
         } else {
           keyValue.value = parseLiteral(stream);
+
+          discardWhitespaceAndComments(stream);
+          isIncluded = consumeConditional(stream, symbols) && isIncluded;
+
+          if (isIncluded && directives != nullptr) {
+            if (const auto directive = DIRECTIVES.find(key); directive != DIRECTIVES.end()) {
+              directives->push_back({ .type = directive->second, .path = std::get<std::string>(keyValue.value) });
+              continue;
+            }
+          }
         }
 
-        values.emplace(std::move(key), std::move(keyValue));
+        // Conditionals are evaluated before insertion so that a failing variant can't shadow a passing one
+        if (isIncluded) {
+          values.emplace(std::move(key), std::move(keyValue));
+        }
 
         discardWhitespaceAndComments(stream);
       }
 
       return std::move(values);
     }
+
+    ParsedDocument parseDocument(const std::string& raw, const ConditionalSymbols* symbols) {
+      PeekableStream stream(raw);
+      std::vector<Directive> directives;
+      auto values = parseKeyValues(stream, symbols, &directives);
+
+      return { .keyValues = KeyValue{ .value = std::move(values) }, .directives = std::move(directives) };
+    }
+
+    void mergeInclude(CaseInsensitiveMap<KeyValue>& target, const CaseInsensitiveMap<KeyValue>& included) {
+      for (const auto& [key, value] : included) {
+        target.emplace(key, value);
+      }
+    }
+
+    void mergeBase(CaseInsensitiveMap<KeyValue>& target, const CaseInsensitiveMap<KeyValue>& base) {
+      for (const auto& [key, value] : base) {
+        const auto [existing, inserted] = target.emplace(key, value);
+        if (inserted) {
+          continue;
+        }
+
+        auto* targetChildren = std::get_if<CaseInsensitiveMap<KeyValue>>(&existing->second.value);
+        const auto* baseChildren = std::get_if<CaseInsensitiveMap<KeyValue>>(&value.value);
+        if (targetChildren != nullptr && baseChildren != nullptr) {
+          mergeBase(*targetChildren, *baseChildren);
+        }
+      }
+    }
+
+    CaseInsensitiveMap<KeyValue> resolveDocument(
+      const std::string& raw,
+      const std::string& path,
+      const IncludeResolver& resolver,
+      ParseCache* cache,
+      const ConditionalSymbols* symbols,
+      std::vector<std::string>& includeChain
+    ) {
+      std::shared_ptr<const ParsedDocument> document;
+      if (cache != nullptr) {
+        document = cache->getOrParse(
+          raw,
+          symbols != nullptr ? symbols->getFingerprint() : 0,
+          [&raw, symbols]() {
+            return parseDocument(raw, symbols);
+          }
+        );
+      } else {
+        document = std::make_shared<const ParsedDocument>(parseDocument(raw, symbols));
+      }
+
+      auto values = std::get<CaseInsensitiveMap<KeyValue>>(document->keyValues.value);
+
+      for (const auto& directive : document->directives) {
+        const auto isCycle = std::ranges::find(includeChain, directive.path) != includeChain.end();
+        if (isCycle || includeChain.size() >= MAX_INCLUDE_DEPTH) {
+          throw Errors::IncludeCycle(("VDF include cycle detected at '" + directive.path + "'").c_str());
+        }
+
+        const auto included = resolver(directive.path, path);
+        if (!included.has_value()) {
+          throw Errors::UnresolvedInclude(("Failed to resolve VDF include '" + directive.path + "'").c_str());
+        }
+
+        includeChain.push_back(directive.path);
+        const auto includedValues = resolveDocument(
+          *included,
+          directive.path,
+          resolver,
+          cache,
+          symbols,
+          includeChain
+        );
+        includeChain.pop_back();
+
+        if (directive.type == Directive::Type::Base) {
+          mergeBase(values, includedValues);
+        } else {
+          mergeInclude(values, includedValues);
+        }
+      }
+
+      return values;
+    }
   }
 
   KeyValue fromString(const std::string& raw) {
     PeekableStream stream(raw);
-    return KeyValue{ .value = parseKeyValues(stream) };
+    return KeyValue{ .value = parseKeyValues(stream, nullptr, nullptr) };
+  }
+
+  KeyValue fromString(const std::string& raw, const ConditionalSymbols& symbols) {
+    PeekableStream stream(raw);
+    return KeyValue{ .value = parseKeyValues(stream, &symbols, nullptr) };
+  }
+
+  KeyValue fromString(
+    const std::string& raw,
+    const IncludeResolver& resolver,
+    ParseCache* cache,
+    const ConditionalSymbols* symbols
+  ) {
+    std::vector<std::string> includeChain;
+    return KeyValue{ .value = resolveDocument(raw, "", resolver, cache, symbols, includeChain) };
   }
 }
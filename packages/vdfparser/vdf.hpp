@@ -1,15 +1,64 @@
 #pragma once
 
+#include <functional>
+#include <optional>
+#include <string>
+#include "conditionals.hpp"
 #include "keyvalue.hpp"
+#include "parse-cache.hpp"
 
 /**
  * Abstracts parsing and accessing the contents of the Valve Data File (VDF) format.
  */
 namespace VdfParser {
+  /**
+   * Loads the contents of a file referenced by an #include or #base directive.
+   * Takes the path exactly as written in the directive, followed by the path of the file containing the directive
+   * (empty for the document passed to fromString), so relative paths can be resolved however the caller needs.
+   * Returns std::nullopt if the file cannot be found.
+   */
+  using IncludeResolver = std::function<std::optional<std::string>(
+    const std::string& path,
+    const std::string& includedFrom
+  )>;
+
   /**
    * Parses a key-value structure from a string containing the raw VDF data.
+   * @remark #include and #base directives are not resolved, and are parsed as regular keys.
+   * @remark Conditional tags (e.g. [$WIN32]) are parsed but not evaluated, so the first of any duplicate keys is kept.
    * @param raw Raw VDF key-value data
    * @return Parsed key-values structure
    */
   KeyValue fromString(const std::string& raw);
+
+  /**
+   * Parses a key-value structure from a string containing the raw VDF data,
+   * dropping any key whose conditional tag (e.g. [$WIN32] or [!$X360]) fails against the given symbols.
+   * @remark #include and #base directives are not resolved, and are parsed as regular keys.
+   * @param raw Raw VDF key-value data
+   * @param symbols Symbols defined for the target platform.
+   * @return Parsed key-values structure
+   */
+  KeyValue fromString(const std::string& raw, const ConditionalSymbols& symbols);
+
+  /**
+   * Parses a key-value structure from a string containing the raw VDF data, resolving top-level #include and #base directives.
+   * Keys in the document always take precedence over those it includes.
+   * An #include adds any top-level keys from the included file which the document does not already have,
+   * while a #base is merged recursively so objects present in both files are combined.
+   * @param raw Raw VDF key-value data
+   * @param resolver Function which loads the contents of included files.
+   * @param cache Optional cache shared between calls, so files included by many documents are only parsed once.
+   * @param symbols Optional symbols to evaluate conditional tags against, applied to included files too.
+   * If null, conditionals are ignored.
+   * @return Parsed key-values structure with all directives resolved
+   * @throws Errors::UnresolvedInclude The resolver could not find an included file.
+   * @throws Errors::IncludeCycle A file includes itself, directly or indirectly.
+   */
+  KeyValue fromString(
+    const std::string& raw,
+    const IncludeResolver& resolver,
+    ParseCache* cache = nullptr,
+    const ConditionalSymbols* symbols = nullptr
+  );
 }
@@ -5,4 +5,6 @@
  */
 namespace VdfParser {}
 
+#include "batch.hpp"
 #include "vdf.hpp"
+#include "writer.hpp"
@@ -0,0 +1,216 @@
+#include "writer.hpp"
+#include <cstring>
+#include <string_view>
+#include "errors.hpp"
+
+namespace VdfParser {
+  using namespace SourceParsers::Internal;
+
+  namespace {
+    constexpr uint8_t BINARY_TYPE_OBJECT = 0x00;
+    constexpr uint8_t BINARY_TYPE_STRING = 0x01;
+    constexpr uint8_t BINARY_TYPE_END = 0x08;
+
+    /**
+     * Sink which only counts the bytes written to it, used for the sizing pass.
+     */
+    class SizeCounter {
+    public:
+      void put(char) {
+        size++;
+      }
+
+      void put(const std::string_view string) {
+        size += string.size();
+      }
+
+      void fill(char, const size_t count) {
+        size += count;
+      }
+
+      [[nodiscard]] size_t getSize() const {
+        return size;
+      }
+
+    private:
+      size_t size = 0;
+    };
+
+    /**
+     * Sink which writes into a buffer already known to be large enough.
+     */
+    template<typename T>
+    class BufferWriter {
+    public:
+      explicit BufferWriter(const std::span<T> buffer) : buffer(buffer) {}
+
+      void put(const char c) {
+        buffer[offset++] = static_cast<T>(c);
+      }
+
+      void put(const std::string_view string) {
+        std::memcpy(buffer.data() + offset, string.data(), string.size());
+        offset += string.size();
+      }
+
+      void fill(const char c, const size_t count) {
+        std::memset(buffer.data() + offset, c, count);
+        offset += count;
+      }
+
+      [[nodiscard]] size_t getSize() const {
+        return offset;
+      }
+
+    private:
+      std::span<T> buffer;
+      size_t offset = 0;
+    };
+
+    const CaseInsensitiveMap<KeyValue>& getRootChildren(const KeyValue& root) {
+      if (!std::holds_alternative<CaseInsensitiveMap<KeyValue>>(root.value)) {
+        throw Errors::UnrepresentableValue("Root key-value must be an object to be written");
+      }
+
+      return std::get<CaseInsensitiveMap<KeyValue>>(root.value);
+    }
+
+    template<typename Sink>
+    void writeQuoted(Sink& sink, const std::string_view string) {
+      if (string.find('"') != std::string_view::npos) {
+        throw Errors::UnrepresentableValue("Key or value contains a double quote, which VDF text cannot represent");
+      }
+
+      sink.put('"');
+      sink.put(string);
+      sink.put('"');
+    }
+
+    template<typename Sink>
+    void writeTextObject(
+      Sink& sink,
+      const CaseInsensitiveMap<KeyValue>& children,
+      const TextFormat format,
+      const size_t depth
+    ) {
+      const auto pretty = format == TextFormat::Pretty;
+
+      for (const auto& [key, child] : children) {
+        if (pretty) {
+          sink.fill('\t', depth);
+        }
+        writeQuoted(sink, key);
+
+        if (const auto* value = std::get_if<std::string>(&child.value)) {
+          if (pretty) {
+            sink.put('\t');
+          }
+          writeQuoted(sink, *value);
+          if (pretty) {
+            sink.put('\n');
+          }
+          continue;
+        }
+
+        if (pretty) {
+          sink.put('\n');
+          sink.fill('\t', depth);
+          sink.put("{\n");
+        } else {
+          sink.put('{');
+        }
+
+        writeTextObject(sink, std::get<CaseInsensitiveMap<KeyValue>>(child.value), format, depth + 1);
+
+        if (pretty) {
+          sink.fill('\t', depth);
+          sink.put("}\n");
+        } else {
+          sink.put('}');
+        }
+      }
+    }
+
+    template<typename Sink>
+    void writeNullTerminated(Sink& sink, const std::string_view string) {
+      if (string.find('\0') != std::string_view::npos) {
+        throw Errors::UnrepresentableValue("Key or value contains a null character, which binary VDF cannot represent");
+      }
+
+      sink.put(string);
+      sink.put('\0');
+    }
+
+    template<typename Sink>
+    void writeBinaryObject(Sink& sink, const CaseInsensitiveMap<KeyValue>& children) {
+      for (const auto& [key, child] : children) {
+        if (const auto* value = std::get_if<std::string>(&child.value)) {
+          sink.put(static_cast<char>(BINARY_TYPE_STRING));
+          writeNullTerminated(sink, key);
+          writeNullTerminated(sink, *value);
+          continue;
+        }
+
+        sink.put(static_cast<char>(BINARY_TYPE_OBJECT));
+        writeNullTerminated(sink, key);
+        writeBinaryObject(sink, std::get<CaseInsensitiveMap<KeyValue>>(child.value));
+      }
+
+      sink.put(static_cast<char>(BINARY_TYPE_END));
+    }
+  }
+
+  size_t getTextSize(const KeyValue& root, const TextFormat format) {
+    SizeCounter counter;
+    writeTextObject(counter, getRootChildren(root), format, 0);
+
+    return counter.getSize();
+  }
+
+  size_t writeText(const KeyValue& root, const std::span<char> buffer, const TextFormat format) {
+    if (getTextSize(root, format) > buffer.size()) {
+      throw Errors::BufferTooSmall("Buffer is too small to hold the VDF text");
+    }
+
+    BufferWriter writer(buffer);
+    writeTextObject(writer, getRootChildren(root), format, 0);
+
+    return writer.getSize();
+  }
+
+  std::string toString(const KeyValue& root, const TextFormat format) {
+    std::string text(getTextSize(root, format), '\0');
+
+    BufferWriter<char> writer(text);
+    writeTextObject(writer, getRootChildren(root), format, 0);
+
+    return text;
+  }
+
+  size_t getBinarySize(const KeyValue& root) {
+    SizeCounter counter;
+    writeBinaryObject(counter, getRootChildren(root));
+
+    return counter.getSize();
+  }
+
+  size_t writeBinary(const KeyValue& root, const std::span<std::byte> buffer) {
+    if (getBinarySize(root) > buffer.size()) {
+      throw Errors::BufferTooSmall("Buffer is too small to hold the binary VDF data");
+    }
+
+    BufferWriter writer(buffer);
+    writeBinaryObject(writer, getRootChildren(root));
+
+    return writer.getSize();
+  }
+
+  std::vector<std::byte> toBinary(const KeyValue& root) {
+    std::vector<std::byte> data(getBinarySize(root));
+
+    BufferWriter<std::byte> writer(data);
+    writeBinaryObject(writer, getRootChildren(root));
+
+    return data;
+  }
+}
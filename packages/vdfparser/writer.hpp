@@ -0,0 +1,81 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string>
+#include <vector>
+#include "keyvalue.hpp"
+
+namespace VdfParser {
+  /**
+   * Layout used when writing key-values back out as text.
+   */
+  enum class TextFormat : uint8_t {
+    /**
+     * No whitespace beyond what is needed to separate tokens. Smallest output, intended for machine consumption.
+     */
+    Compact,
+    /**
+     * Tab indented with one key per line, matching the layout used by Valve's tools.
+     */
+    Pretty
+  };
+
+  /**
+   * Computes the exact number of bytes writeText will produce for the given key-values, without writing anything.
+   * @param root Root object to write. Its children become the top-level keys of the output.
+   * @param format Layout of the output.
+   * @return Size of the text in bytes.
+   * @throws Errors::UnrepresentableValue A key or value contains a double quote, or root is not an object.
+   */
+  [[nodiscard]] size_t getTextSize(const KeyValue& root, TextFormat format = TextFormat::Pretty);
+
+  /**
+   * Writes the key-values as VDF text into a caller-provided buffer.
+   * @remark The output is not null terminated.
+   * @param root Root object to write. Its children become the top-level keys of the output.
+   * @param buffer Destination buffer, which must be at least getTextSize bytes long.
+   * @param format Layout of the output.
+   * @return Number of bytes written.
+   * @throws Errors::BufferTooSmall The buffer cannot hold the output.
+   * @throws Errors::UnrepresentableValue A key or value contains a double quote, or root is not an object.
+   */
+  size_t writeText(const KeyValue& root, std::span<char> buffer, TextFormat format = TextFormat::Pretty);
+
+  /**
+   * Writes the key-values as VDF text into a new string, allocated once at its final size.
+   * @param root Root object to write. Its children become the top-level keys of the output.
+   * @param format Layout of the output.
+   * @return VDF text which can be parsed again with fromString.
+   * @throws Errors::UnrepresentableValue A key or value contains a double quote, or root is not an object.
+   */
+  [[nodiscard]] std::string toString(const KeyValue& root, TextFormat format = TextFormat::Pretty);
+
+  /**
+   * Computes the exact number of bytes writeBinary will produce for the given key-values, without writing anything.
+   * @param root Root object to write. Its children become the top-level keys of the output.
+   * @return Size of the binary data in bytes.
+   * @throws Errors::UnrepresentableValue A key or value contains a null character, or root is not an object.
+   */
+  [[nodiscard]] size_t getBinarySize(const KeyValue& root);
+
+  /**
+   * Writes the key-values in the binary KeyValues format into a caller-provided buffer.
+   * @remark Every value is written as a string, as KeyValue does not retain the original value types.
+   * @param root Root object to write. Its children become the top-level keys of the output.
+   * @param buffer Destination buffer, which must be at least getBinarySize bytes long.
+   * @return Number of bytes written.
+   * @throws Errors::BufferTooSmall The buffer cannot hold the output.
+   * @throws Errors::UnrepresentableValue A key or value contains a null character, or root is not an object.
+   */
+  size_t writeBinary(const KeyValue& root, std::span<std::byte> buffer);
+
+  /**
+   * Writes the key-values in the binary KeyValues format into a new buffer, allocated once at its final size.
+   * @param root Root object to write. Its children become the top-level keys of the output.
+   * @return Binary KeyValues data.
+   * @throws Errors::UnrepresentableValue A key or value contains a null character, or root is not an object.
+   */
+  [[nodiscard]] std::vector<std::byte> toBinary(const KeyValue& root);
+}
@@ -0,0 +1,340 @@
+#include "decode.hpp"
+#include <algorithm>
+#include <source-parsers-shared/errors.hpp>
+#include <source-parsers-shared/internal/parallel-for.hpp>
+#include "decoders/block-compressed.hpp"
+#include "decoders/uncompressed.hpp"
+#include "helpers/image-sizes.hpp"
+
+namespace VtfParser {
+  using namespace SourceParsers::Errors;
+  using namespace SourceParsers::Internal;
+  using namespace VtfParser::Internal;
+
+  namespace {
+    constexpr size_t RGBA8_PIXEL_SIZE = 4;
+    constexpr size_t RGBA32F_PIXEL_SIZE = 4 * sizeof(float);
+
+    /**
+     * Rows decoded by each batch job. A multiple of 4, so bands of block compressed images start on a block boundary.
+     */
+    constexpr uint32_t DECODE_BAND_ROWS = 64;
+
+    void checkSourceSize(
+      const ImageFormat format,
+      const std::span<const std::byte> data,
+      const uint32_t width,
+      const uint32_t height
+    ) {
+      const auto dataSize = getSliceSizeBytes(
+        { .format = format, .width = width, .height = height, .depth = 1, .faces = 1, .frames = 1, .mipLevels = 1 }
+      );
+      if (data.size() < dataSize) {
+        throw OutOfBoundsAccess("Image data is too short for the given extent");
+      }
+    }
+
+    void decodeBlockCompressed(
+      const ImageFormat format,
+      const std::span<const std::byte> data,
+      const uint32_t width,
+      const uint32_t height,
+      const std::span<std::byte> output
+    ) {
+      switch (format) {
+        case ImageFormat::DXT1:
+          decodeDxt1(data, width, height, false, output);
+          break;
+        case ImageFormat::DXT1_ONEBITALPHA:
+          decodeDxt1(data, width, height, true, output);
+          break;
+        case ImageFormat::DXT3:
+          decodeDxt3(data, width, height, output);
+          break;
+        default:
+          decodeDxt5(data, width, height, output);
+          break;
+      }
+    }
+
+    /**
+     * Implementation of decodeToRgba32f over a byte buffer, so the batch decoder can write into untyped output.
+     */
+    void decodeToRgba32fBytes(
+      const ImageFormat format,
+      const std::span<const std::byte> data,
+      const uint32_t width,
+      const uint32_t height,
+      const std::span<std::byte> output
+    ) {
+      const auto converter = getRgba32fConverter(format);
+      if (!converter && !isBlockCompressed(format)) {
+        throw UnsupportedFormat("Image format cannot be decoded to RGBA32F");
+      }
+
+      const auto pixelCount = static_cast<size_t>(width) * height;
+      checkSourceSize(format, data, width, height);
+      if (output.size() < pixelCount * RGBA32F_PIXEL_SIZE) {
+        throw OutOfBoundsAccess("Output buffer is too small to hold the decoded image");
+      }
+
+      if (converter) {
+        converter(data.data(), output.data(), pixelCount);
+        return;
+      }
+
+      // Decode into the last quarter of the output, then widen forwards into the whole buffer in place
+      const auto staging = output.subspan(
+        pixelCount * (RGBA32F_PIXEL_SIZE - RGBA8_PIXEL_SIZE),
+        pixelCount * RGBA8_PIXEL_SIZE
+      );
+      decodeBlockCompressed(format, data, width, height, staging);
+      widenRgba8ToRgba32f(staging.data(), output.data(), pixelCount);
+    }
+
+    size_t getDecodedPixelSize(const DecodedFormat format) {
+      return format == DecodedFormat::Rgba8 ? RGBA8_PIXEL_SIZE : RGBA32F_PIXEL_SIZE;
+    }
+
+    /**
+     * Strides of one mip level within the decoded image.
+     */
+    struct DecodedMipLayout {
+      size_t sliceSizeBytes;
+      size_t faceSizeBytes;
+      size_t frameSizeBytes;
+      size_t sizeBytes;
+    };
+
+    DecodedMipLayout getDecodedMipLayout(const Vtf& vtf, const DecodedFormat format, const uint8_t mipLevel) {
+      const auto extent = vtf.getHighResImageExtent(mipLevel);
+
+      DecodedMipLayout layout{};
+      layout.sliceSizeBytes = static_cast<size_t>(extent.width) * extent.height * getDecodedPixelSize(format);
+      layout.faceSizeBytes = layout.sliceSizeBytes * extent.depth;
+      layout.frameSizeBytes = layout.faceSizeBytes * vtf.getFaces();
+      layout.sizeBytes = layout.frameSizeBytes * vtf.getFrames();
+
+      return layout;
+    }
+
+    /**
+     * A band of rows within one slice, which is the unit of work for the batch decoder.
+     */
+    struct DecodeJob {
+      uint8_t mipLevel;
+      uint16_t frame;
+      uint8_t face;
+      uint16_t depth;
+      uint32_t firstRow;
+      uint32_t rowCount;
+    };
+
+    std::vector<DecodeJob> getDecodeJobs(const Vtf& vtf) {
+      std::vector<DecodeJob> jobs;
+
+      // Largest mips first, so the most expensive work is claimed before the small tail
+      for (uint8_t mipLevel = 0; mipLevel < vtf.getMipLevels(); mipLevel++) {
+        const auto extent = vtf.getHighResImageExtent(mipLevel);
+
+        for (uint16_t frame = 0; frame < vtf.getFrames(); frame++) {
+          for (uint8_t face = 0; face < vtf.getFaces(); face++) {
+            for (uint16_t depth = 0; depth < extent.depth; depth++) {
+              for (uint32_t row = 0; row < extent.height; row += DECODE_BAND_ROWS) {
+                jobs.push_back(
+                  {
+                    .mipLevel = mipLevel,
+                    .frame = frame,
+                    .face = face,
+                    .depth = depth,
+                    .firstRow = row,
+                    .rowCount = std::min<uint32_t>(DECODE_BAND_ROWS, extent.height - row),
+                  }
+                );
+              }
+            }
+          }
+        }
+      }
+
+      return jobs;
+    }
+  }
+
+  size_t getRgba8SizeBytes(const uint32_t width, const uint32_t height) {
+    return static_cast<size_t>(width) * height * 4;
+  }
+
+  size_t getRgba32fSizeFloats(const uint32_t width, const uint32_t height) {
+    return static_cast<size_t>(width) * height * 4;
+  }
+
+  void decodeToRgba8(
+    const ImageFormat format,
+    const std::span<const std::byte> data,
+    const uint32_t width,
+    const uint32_t height,
+    const std::span<std::byte> output
+  ) {
+    const auto converter = getRgba8Converter(format);
+    if (!converter && !isBlockCompressed(format)) {
+      throw UnsupportedFormat("Image format cannot be decoded to RGBA8");
+    }
+
+    checkSourceSize(format, data, width, height);
+    if (output.size() < getRgba8SizeBytes(width, height)) {
+      throw OutOfBoundsAccess("Output buffer is too small to hold the decoded image");
+    }
+
+    if (converter) {
+      converter(data.data(), output.data(), static_cast<size_t>(width) * height);
+    } else {
+      decodeBlockCompressed(format, data, width, height, output);
+    }
+  }
+
+  void decodeToRgba32f(
+    const ImageFormat format,
+    const std::span<const std::byte> data,
+    const uint32_t width,
+    const uint32_t height,
+    const std::span<float> output
+  ) {
+    decodeToRgba32fBytes(format, data, width, height, std::as_writable_bytes(output));
+  }
+
+  void decodeSliceToRgba8(
+    const Vtf& vtf,
+    const std::span<std::byte> output,
+    const uint8_t mipLevel,
+    const uint16_t frame,
+    const uint8_t face,
+    const uint16_t depth
+  ) {
+    const auto extent = vtf.getHighResImageExtent(mipLevel);
+    const auto data = vtf.getImageSlice(mipLevel, frame, face, depth);
+
+    decodeToRgba8(vtf.getHighResImageFormat(), data, extent.width, extent.height, output);
+  }
+
+  void decodeSliceToRgba32f(
+    const Vtf& vtf,
+    const std::span<float> output,
+    const uint8_t mipLevel,
+    const uint16_t frame,
+    const uint8_t face,
+    const uint16_t depth
+  ) {
+    const auto extent = vtf.getHighResImageExtent(mipLevel);
+    const auto data = vtf.getImageSlice(mipLevel, frame, face, depth);
+
+    decodeToRgba32f(vtf.getHighResImageFormat(), data, extent.width, extent.height, output);
+  }
+
+  size_t getDecodedImageSizeBytes(const Vtf& vtf, const DecodedFormat format) {
+    size_t size = 0;
+    for (uint8_t mipLevel = 0; mipLevel < vtf.getMipLevels(); mipLevel++) {
+      size += getDecodedMipLayout(vtf, format, mipLevel).sizeBytes;
+    }
+
+    return size;
+  }
+
+  size_t getDecodedSliceOffset(
+    const Vtf& vtf,
+    const DecodedFormat format,
+    const uint8_t mipLevel,
+    const uint16_t frame,
+    const uint8_t face,
+    const uint16_t depth
+  ) {
+    if (mipLevel >= vtf.getMipLevels()) {
+      throw OutOfBoundsAccess("Requested VTF mip level does not exist");
+    }
+
+    // Same order as the VTF itself, so smaller mips come first
+    size_t offset = 0;
+    for (uint8_t i = vtf.getMipLevels() - 1; i > mipLevel; i--) {
+      offset += getDecodedMipLayout(vtf, format, i).sizeBytes;
+    }
+
+    const auto layout = getDecodedMipLayout(vtf, format, mipLevel);
+    offset += layout.frameSizeBytes * frame;
+    offset += layout.faceSizeBytes * face;
+    offset += layout.sliceSizeBytes * depth;
+
+    return offset;
+  }
+
+  void decodeImage(
+    const Vtf& vtf,
+    const DecodedFormat format,
+    const std::span<std::byte> output,
+    const unsigned int threadCount
+  ) {
+    const auto imageFormat = vtf.getHighResImageFormat();
+    const auto converter = format == DecodedFormat::Rgba8 ? getRgba8Converter(imageFormat) :
+                           getRgba32fConverter(imageFormat);
+    if (!converter && !isBlockCompressed(imageFormat)) {
+      throw UnsupportedFormat("Image format cannot be decoded");
+    }
+
+    if (output.size() < getDecodedImageSizeBytes(vtf, format)) {
+      throw OutOfBoundsAccess("Output buffer is too small to hold the decoded image");
+    }
+
+    // Mip offsets are resolved up front, so workers only do arithmetic within their slice
+    std::vector<size_t> mipOffsets(vtf.getMipLevels());
+    for (uint8_t mipLevel = 0; mipLevel < vtf.getMipLevels(); mipLevel++) {
+      mipOffsets[mipLevel] = getDecodedSliceOffset(vtf, format, mipLevel);
+    }
+
+    const auto jobs = getDecodeJobs(vtf);
+    const auto pixelSize = getDecodedPixelSize(format);
+
+    parallelFor(
+      jobs.size(),
+      threadCount,
+      [&](const size_t index) {
+        const auto& job = jobs[index];
+        const auto extent = vtf.getHighResImageExtent(job.mipLevel);
+        const auto slice = vtf.getImageSlice(job.mipLevel, job.frame, job.face, job.depth);
+
+        const auto sourceOffset = isBlockCompressed(imageFormat) ?
+                                    (job.firstRow / 4) * ((extent.width + 3u) / 4) * getBlockSizeBytes(imageFormat) :
+                                    static_cast<size_t>(job.firstRow) * extent.width * getPixelSizeBytes(imageFormat);
+
+        const auto layout = getDecodedMipLayout(vtf, format, job.mipLevel);
+        const auto outputOffset = mipOffsets[job.mipLevel] + layout.frameSizeBytes * job.frame +
+          layout.faceSizeBytes * job.face + layout.sliceSizeBytes * job.depth +
+          static_cast<size_t>(job.firstRow) * extent.width * pixelSize;
+        const auto bandSize = static_cast<size_t>(job.rowCount) * extent.width * pixelSize;
+
+        if (format == DecodedFormat::Rgba8) {
+          decodeToRgba8(
+            imageFormat,
+            slice.subspan(sourceOffset),
+            extent.width,
+            job.rowCount,
+            output.subspan(outputOffset, bandSize)
+          );
+        } else {
+          decodeToRgba32fBytes(
+            imageFormat,
+            slice.subspan(sourceOffset),
+            extent.width,
+            job.rowCount,
+            output.subspan(outputOffset, bandSize)
+          );
+        }
+      }
+    );
+  }
+
+  std::vector<std::byte> decodeImage(const Vtf& vtf, const DecodedFormat format, const unsigned int threadCount) {
+    std::vector<std::byte> output(getDecodedImageSizeBytes(vtf, format));
+    decodeImage(vtf, format, output, threadCount);
+
+    return output;
+  }
+}
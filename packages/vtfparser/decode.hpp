@@ -0,0 +1,172 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+#include "vtf.hpp"
+
+namespace VtfParser {
+  /**
+   * Pixel format produced when decoding a whole image.
+   */
+  enum class DecodedFormat : uint8_t {
+    /**
+     * One byte per channel, in R, G, B, A order.
+     */
+    Rgba8,
+    /**
+     * One float per channel, in R, G, B, A order.
+     */
+    Rgba32f
+  };
+
+  /**
+   * Gets the number of bytes needed to hold an image of the given size once decoded to RGBA8.
+   * @param width Width of the image in pixels.
+   * @param height Height of the image in pixels.
+   * @return Size of the decoded image in bytes.
+   */
+  [[nodiscard]] size_t getRgba8SizeBytes(uint32_t width, uint32_t height);
+
+  /**
+   * Decodes a single 2D image to tightly packed RGBA8 (one byte per channel, in R, G, B, A order).
+   * @remark Every format except P8 is supported. Floating point formats are clamped to [0, 1].
+   * @param format Format of the source data.
+   * @param data Source image data, e.g. a slice of Vtf::getHighResImageData().
+   * @param width Width of the image in pixels.
+   * @param height Height of the image in pixels.
+   * @param output Destination buffer, which must be at least getRgba8SizeBytes bytes long.
+   * @throws Errors::UnsupportedFormat The format cannot be decoded.
+   * @throws Errors::OutOfBoundsAccess The source data is too short for the image, or the output is too small.
+   */
+  void decodeToRgba8(
+    ImageFormat format,
+    std::span<const std::byte> data,
+    uint32_t width,
+    uint32_t height,
+    std::span<std::byte> output
+  );
+
+  /**
+   * Gets the number of floats needed to hold an image of the given size once decoded to RGBA32F.
+   * @param width Width of the image in pixels.
+   * @param height Height of the image in pixels.
+   * @return Size of the decoded image in floats.
+   */
+  [[nodiscard]] size_t getRgba32fSizeFloats(uint32_t width, uint32_t height);
+
+  /**
+   * Decodes a single 2D image to tightly packed RGBA32F (one float per channel, in R, G, B, A order).
+   * @remark Every format except P8 is supported. Normalised formats are mapped to [0, 1], while RGBA16161616F keeps
+   * @remark its full range.
+   * @param format Format of the source data.
+   * @param data Source image data, e.g. a slice of Vtf::getHighResImageData().
+   * @param width Width of the image in pixels.
+   * @param height Height of the image in pixels.
+   * @param output Destination buffer, which must be at least getRgba32fSizeFloats floats long.
+   * @throws Errors::UnsupportedFormat The format cannot be decoded.
+   * @throws Errors::OutOfBoundsAccess The source data is too short for the image, or the output is too small.
+   */
+  void decodeToRgba32f(
+    ImageFormat format,
+    std::span<const std::byte> data,
+    uint32_t width,
+    uint32_t height,
+    std::span<float> output
+  );
+
+  /**
+   * Decodes one slice of the high resolution image to tightly packed RGBA8.
+   * @param vtf Texture to decode from.
+   * @param output Destination buffer, which must be at least getRgba8SizeBytes bytes long for the mip level's extent.
+   * @param mipLevel Level of the mipmap chain.
+   * @param frame Frame of animation.
+   * @param face Face of a cubemap.
+   * @param depth Depth or Z value of a volumetric texture.
+   * @throws Errors::UnsupportedFormat The texture's format cannot be decoded.
+   * @throws Errors::OutOfBoundsAccess The slice does not exist, its data is truncated, or the output is too small.
+   */
+  void decodeSliceToRgba8(
+    const Vtf& vtf,
+    std::span<std::byte> output,
+    uint8_t mipLevel = 0,
+    uint16_t frame = 0,
+    uint8_t face = 0,
+    uint16_t depth = 0
+  );
+
+  /**
+   * Decodes one slice of the high resolution image to tightly packed RGBA32F.
+   * @param vtf Texture to decode from.
+   * @param output Destination buffer, which must be at least getRgba32fSizeFloats floats long for the mip level's
+   * extent.
+   * @param mipLevel Level of the mipmap chain.
+   * @param frame Frame of animation.
+   * @param face Face of a cubemap.
+   * @param depth Depth or Z value of a volumetric texture.
+   * @throws Errors::UnsupportedFormat The texture's format cannot be decoded.
+   * @throws Errors::OutOfBoundsAccess The slice does not exist, its data is truncated, or the output is too small.
+   */
+  void decodeSliceToRgba32f(
+    const Vtf& vtf,
+    std::span<float> output,
+    uint8_t mipLevel = 0,
+    uint16_t frame = 0,
+    uint8_t face = 0,
+    uint16_t depth = 0
+  );
+
+  /**
+   * Gets the number of bytes needed to hold every slice of the high resolution image once decoded.
+   * @param vtf Texture to decode.
+   * @param format Decoded pixel format.
+   * @return Size of the decoded image in bytes.
+   */
+  [[nodiscard]] size_t getDecodedImageSizeBytes(const Vtf& vtf, DecodedFormat format);
+
+  /**
+   * Gets the offset of a slice within the output of decodeImage().
+   * @remark Slices are laid out in the same order as the VTF itself (smallest mip first, then frames, faces and depth).
+   * @param vtf Texture being decoded.
+   * @param format Decoded pixel format.
+   * @param mipLevel Level of the mipmap chain.
+   * @param frame Frame of animation.
+   * @param face Face of a cubemap.
+   * @param depth Depth or Z value of a volumetric texture.
+   * @return Offset (in bytes) into the decoded image.
+   * @throws Errors::OutOfBoundsAccess The mip level does not exist.
+   */
+  [[nodiscard]] size_t getDecodedSliceOffset(
+    const Vtf& vtf,
+    DecodedFormat format,
+    uint8_t mipLevel = 0,
+    uint16_t frame = 0,
+    uint8_t face = 0,
+    uint16_t depth = 0
+  );
+
+  /**
+   * Decodes every mip level, frame, face and depth slice of the high resolution image into one buffer.
+   * Slices are split into bands of rows, which are decoded in parallel across a pool of worker threads.
+   * @param vtf Texture to decode. Must have been loaded with Vtf::LoadMode::Full.
+   * @param format Decoded pixel format.
+   * @param output Destination buffer, which must be at least getDecodedImageSizeBytes bytes long.
+   * @param threadCount Number of worker threads, or 0 for one per hardware thread.
+   * @throws Errors::UnsupportedFormat The texture's format cannot be decoded.
+   * @throws Errors::OutOfBoundsAccess The image data is truncated, or the output is too small.
+   */
+  void decodeImage(const Vtf& vtf, DecodedFormat format, std::span<std::byte> output, unsigned int threadCount = 0);
+
+  /**
+   * Decodes every mip level, frame, face and depth slice of the high resolution image into a new buffer, allocated
+   * once at its final size.
+   * @param vtf Texture to decode. Must have been loaded with Vtf::LoadMode::Full.
+   * @param format Decoded pixel format.
+   * @param threadCount Number of worker threads, or 0 for one per hardware thread.
+   * @return Decoded image, laid out as described by getDecodedSliceOffset().
+   * @throws Errors::UnsupportedFormat The texture's format cannot be decoded.
+   * @throws Errors::OutOfBoundsAccess The image data is truncated.
+   */
+  [[nodiscard]] std::vector<std::byte> decodeImage(const Vtf& vtf, DecodedFormat format, unsigned int threadCount = 0);
+}
@@ -0,0 +1,230 @@
+#include "block-compressed.hpp"
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include "../helpers/rgb565.hpp"
+#include "../helpers/simd.hpp"
+
+namespace VtfParser::Internal {
+  namespace {
+    constexpr uint32_t OPAQUE_ALPHA = 0xff000000;
+    constexpr uint32_t COLOUR_MASK = 0x00ffffff;
+
+    constexpr size_t BLOCK_DIMENSION = 4;
+    constexpr size_t DXT1_BLOCK_SIZE = 8;
+    constexpr size_t DXT3_DXT5_BLOCK_SIZE = 16;
+
+    /**
+     * A decoded 4x4 block of RGBA8 pixels (as little-endian uint32s), row by row.
+     */
+    using PixelBlock = std::array<uint32_t, BLOCK_DIMENSION * BLOCK_DIMENSION>;
+    using Palette = std::array<uint32_t, 4>;
+    using AlphaBlock = std::array<uint8_t, BLOCK_DIMENSION * BLOCK_DIMENSION>;
+
+    template<typename T>
+    T read(const std::byte* data) {
+      T value;
+      std::memcpy(&value, data, sizeof(T));
+      return value;
+    }
+
+    /**
+     * Builds the four colour palette of a colour block.
+     * @param colourBlock Pointer to the two 565 endpoints.
+     * @param allowThreeColour Whether c0 <= c1 selects three colour mode (DXT1 only).
+     * @param transparent Colour to use for index 3 in three colour mode.
+     */
+    Palette buildPalette(const std::byte* colourBlock, const bool allowThreeColour, const uint32_t transparent) {
+      return getDxtPalette(read<uint16_t>(colourBlock), read<uint16_t>(colourBlock + 2), allowThreeColour, transparent);
+    }
+
+    /**
+     * Selects each pixel of the block from the palette using its 2-bit index.
+     */
+    void writeColours(const Palette& palette, const uint32_t indices, PixelBlock& block) {
+#if VTFPARSER_SSE2
+      const auto p0 = _mm_set1_epi32(static_cast<int>(palette[0]));
+      const auto p1 = _mm_set1_epi32(static_cast<int>(palette[1]));
+      const auto p2 = _mm_set1_epi32(static_cast<int>(palette[2]));
+      const auto p3 = _mm_set1_epi32(static_cast<int>(palette[3]));
+
+      // Each lane isolates its own 2 bits of the row's index byte, then compares against that index pre-shifted
+      const auto laneMask = _mm_setr_epi32(0x03, 0x0c, 0x30, 0xc0);
+      const auto index1 = _mm_setr_epi32(0x01, 0x04, 0x10, 0x40);
+      const auto index2 = _mm_setr_epi32(0x02, 0x08, 0x20, 0x80);
+
+      const auto select = [](const __m128i mask, const __m128i ifSet, const __m128i otherwise) {
+        return _mm_or_si128(_mm_and_si128(mask, ifSet), _mm_andnot_si128(mask, otherwise));
+      };
+
+      for (size_t row = 0; row < BLOCK_DIMENSION; row++) {
+        const auto rowIndices = static_cast<int>((indices >> (row * 8)) & 0xffu);
+        const auto bits = _mm_and_si128(_mm_set1_epi32(rowIndices), laneMask);
+
+        auto pixels = p0;
+        pixels = select(_mm_cmpeq_epi32(bits, index1), p1, pixels);
+        pixels = select(_mm_cmpeq_epi32(bits, index2), p2, pixels);
+        pixels = select(_mm_cmpeq_epi32(bits, laneMask), p3, pixels);
+
+        _mm_store_si128(reinterpret_cast<__m128i*>(&block[row * BLOCK_DIMENSION]), pixels);
+      }
+#else
+      for (size_t i = 0; i < block.size(); i++) {
+        block[i] = palette[(indices >> (i * 2)) & 0x3u];
+      }
+#endif
+    }
+
+    /**
+     * Replaces the alpha channel of every pixel in the block.
+     */
+    void writeAlphas(const AlphaBlock& alphas, PixelBlock& block) {
+#if VTFPARSER_SSE2
+      const auto zero = _mm_setzero_si128();
+      const auto colourMask = _mm_set1_epi32(static_cast<int>(COLOUR_MASK));
+
+      for (size_t row = 0; row < BLOCK_DIMENSION; row++) {
+        auto rowAlphas = _mm_cvtsi32_si128(read<int32_t>(reinterpret_cast<const std::byte*>(&alphas[row * 4])));
+        rowAlphas = _mm_unpacklo_epi16(_mm_unpacklo_epi8(rowAlphas, zero), zero);
+
+        auto* pixels = reinterpret_cast<__m128i*>(&block[row * BLOCK_DIMENSION]);
+        const auto colours = _mm_and_si128(_mm_load_si128(pixels), colourMask);
+        _mm_store_si128(pixels, _mm_or_si128(colours, _mm_slli_epi32(rowAlphas, 24)));
+      }
+#else
+      for (size_t i = 0; i < block.size(); i++) {
+        block[i] = (block[i] & COLOUR_MASK) | static_cast<uint32_t>(alphas[i]) << 24u;
+      }
+#endif
+    }
+
+    AlphaBlock decodeExplicitAlpha(const std::byte* alphaBlock) {
+      const auto bits = read<uint64_t>(alphaBlock);
+
+      AlphaBlock alphas;
+      for (size_t i = 0; i < alphas.size(); i++) {
+        alphas[i] = static_cast<uint8_t>(((bits >> (i * 4)) & 0xfu) * 17u);
+      }
+
+      return alphas;
+    }
+
+    AlphaBlock decodeInterpolatedAlpha(const std::byte* alphaBlock) {
+      const auto a0 = static_cast<uint32_t>(alphaBlock[0]);
+      const auto a1 = static_cast<uint32_t>(alphaBlock[1]);
+
+      std::array<uint8_t, 8> palette{ static_cast<uint8_t>(a0), static_cast<uint8_t>(a1) };
+      if (a0 > a1) {
+        for (uint32_t i = 1; i < 7; i++) {
+          palette[i + 1] = static_cast<uint8_t>(((7 - i) * a0 + i * a1) / 7);
+        }
+      } else {
+        for (uint32_t i = 1; i < 5; i++) {
+          palette[i + 1] = static_cast<uint8_t>(((5 - i) * a0 + i * a1) / 5);
+        }
+        palette[6] = 0;
+        palette[7] = 255;
+      }
+
+      uint64_t indices = 0;
+      std::memcpy(&indices, alphaBlock + 2, 6);
+
+      AlphaBlock alphas;
+      for (size_t i = 0; i < alphas.size(); i++) {
+        alphas[i] = palette[(indices >> (i * 3)) & 0x7u];
+      }
+
+      return alphas;
+    }
+
+    /**
+     * Walks every block of the image, decoding each with decodeBlock and copying the visible pixels to output.
+     */
+    template<size_t BlockSize, typename DecodeBlock>
+    void decodeBlocks(
+      const std::span<const std::byte> blocks,
+      const uint32_t width,
+      const uint32_t height,
+      const std::span<std::byte> output,
+      const DecodeBlock& decodeBlock
+    ) {
+      const size_t blocksWide = (width + 3) / BLOCK_DIMENSION;
+      const size_t blocksHigh = (height + 3) / BLOCK_DIMENSION;
+      const size_t rowPitch = static_cast<size_t>(width) * sizeof(uint32_t);
+
+      alignas(16) PixelBlock block;
+
+      for (size_t blockY = 0; blockY < blocksHigh; blockY++) {
+        const auto rows = std::min<size_t>(BLOCK_DIMENSION, height - blockY * BLOCK_DIMENSION);
+
+        for (size_t blockX = 0; blockX < blocksWide; blockX++) {
+          decodeBlock(&blocks[(blockY * blocksWide + blockX) * BlockSize], block);
+
+          const auto columns = std::min<size_t>(BLOCK_DIMENSION, width - blockX * BLOCK_DIMENSION);
+          auto* destination = &output[blockY * BLOCK_DIMENSION * rowPitch + blockX * BLOCK_DIMENSION * sizeof(uint32_t)];
+
+          for (size_t row = 0; row < rows; row++) {
+            std::memcpy(destination + row * rowPitch, &block[row * BLOCK_DIMENSION], columns * sizeof(uint32_t));
+          }
+        }
+      }
+    }
+  }
+
+  void decodeDxt1(
+    const std::span<const std::byte> blocks,
+    const uint32_t width,
+    const uint32_t height,
+    const bool oneBitAlpha,
+    const std::span<std::byte> output
+  ) {
+    // Plain DXT1 has no alpha, so the "transparent" colour is treated as opaque black
+    const uint32_t transparent = oneBitAlpha ? 0 : OPAQUE_ALPHA;
+
+    decodeBlocks<DXT1_BLOCK_SIZE>(
+      blocks,
+      width,
+      height,
+      output,
+      [transparent](const std::byte* data, PixelBlock& block) {
+        writeColours(buildPalette(data, true, transparent), read<uint32_t>(data + 4), block);
+      }
+    );
+  }
+
+  void decodeDxt3(
+    const std::span<const std::byte> blocks,
+    const uint32_t width,
+    const uint32_t height,
+    const std::span<std::byte> output
+  ) {
+    decodeBlocks<DXT3_DXT5_BLOCK_SIZE>(
+      blocks,
+      width,
+      height,
+      output,
+      [](const std::byte* data, PixelBlock& block) {
+        writeColours(buildPalette(data + 8, false, 0), read<uint32_t>(data + 12), block);
+        writeAlphas(decodeExplicitAlpha(data), block);
+      }
+    );
+  }
+
+  void decodeDxt5(
+    const std::span<const std::byte> blocks,
+    const uint32_t width,
+    const uint32_t height,
+    const std::span<std::byte> output
+  ) {
+    decodeBlocks<DXT3_DXT5_BLOCK_SIZE>(
+      blocks,
+      width,
+      height,
+      output,
+      [](const std::byte* data, PixelBlock& block) {
+        writeColours(buildPalette(data + 8, false, 0), read<uint32_t>(data + 12), block);
+        writeAlphas(decodeInterpolatedAlpha(data), block);
+      }
+    );
+  }
+}
@@ -0,0 +1,41 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+namespace VtfParser::Internal {
+  /**
+   * Decodes DXT1 (BC1) blocks to tightly packed RGBA8.
+   * @param blocks Compressed blocks, row by row.
+   * @param width Width of the image in pixels.
+   * @param height Height of the image in pixels.
+   * @param oneBitAlpha Whether the fourth colour of three-colour blocks is transparent, rather than opaque black.
+   * @param output Destination for width * height RGBA8 pixels.
+   */
+  void decodeDxt1(
+    std::span<const std::byte> blocks,
+    uint32_t width,
+    uint32_t height,
+    bool oneBitAlpha,
+    std::span<std::byte> output
+  );
+
+  /**
+   * Decodes DXT3 (BC2) blocks to tightly packed RGBA8.
+   * @param blocks Compressed blocks, row by row.
+   * @param width Width of the image in pixels.
+   * @param height Height of the image in pixels.
+   * @param output Destination for width * height RGBA8 pixels.
+   */
+  void decodeDxt3(std::span<const std::byte> blocks, uint32_t width, uint32_t height, std::span<std::byte> output);
+
+  /**
+   * Decodes DXT5 (BC3) blocks to tightly packed RGBA8.
+   * @param blocks Compressed blocks, row by row.
+   * @param width Width of the image in pixels.
+   * @param height Height of the image in pixels.
+   * @param output Destination for width * height RGBA8 pixels.
+   */
+  void decodeDxt5(std::span<const std::byte> blocks, uint32_t width, uint32_t height, std::span<std::byte> output);
+}
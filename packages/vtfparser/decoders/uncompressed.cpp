@@ -0,0 +1,403 @@
+#include "uncompressed.hpp"
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+#include <utility>
+#include <source-parsers-shared/internal/half-float.hpp>
+#include "../helpers/simd.hpp"
+
+namespace VtfParser::Internal {
+  using SourceParsers::Internal::halfToFloat;
+
+  namespace {
+    using Rgba8 = std::array<uint8_t, 4>;
+    using Rgba32f = std::array<float, 4>;
+
+    /**
+     * One past the highest ImageFormat value, used to size the dispatch tables.
+     */
+    constexpr size_t FORMAT_COUNT = static_cast<size_t>(ImageFormat::UVLX8888) + 1;
+
+    /**
+     * Number of pixels staged on the stack when a conversion goes through RGBA8 first.
+     */
+    constexpr size_t STAGING_PIXELS = 256;
+
+    constexpr float INV_255 = 1.0f / 255.0f;
+
+    template<typename T>
+    T read(const std::byte* data) {
+      T value;
+      std::memcpy(&value, data, sizeof(T));
+      return value;
+    }
+
+    /**
+     * Expands an n-bit channel to 8 bits by replicating its high bits into the low bits.
+     */
+    template<unsigned Bits>
+    constexpr uint8_t expandBits(const uint32_t value) {
+      if constexpr (Bits == 1) {
+        return value ? 0xff : 0;
+      } else if constexpr (Bits >= 4) {
+        return static_cast<uint8_t>((value << (8 - Bits)) | (value >> (2 * Bits - 8)));
+      }
+    }
+
+    uint8_t floatToUnorm8(const float value) {
+      // Written so NaN falls through to 0
+      const auto clamped = value > 0.0f ? std::min(value, 1.0f) : 0.0f;
+      return static_cast<uint8_t>(clamped * 255.0f + 0.5f);
+    }
+
+    /**
+     * Per-format pixel loader. Specialisations provide the pixel size and a load function returning either Rgba8 or
+     * Rgba32f, depending on the precision of the source format.
+     */
+    template<ImageFormat Format>
+    struct Kernel {
+      static constexpr bool SUPPORTED = false;
+    };
+
+    /**
+     * Loader for 32-bit formats which are a byte permutation of RGBA. Each parameter is the source byte of that
+     * channel, or -1 for a channel which is always opaque.
+     */
+    template<int R, int G, int B, int A>
+    struct Swizzle32Kernel {
+      static constexpr bool SUPPORTED = true;
+      static constexpr bool SWIZZLE32 = true;
+      static constexpr size_t SIZE = 4;
+
+      static Rgba8 load(const std::byte* data) {
+        const auto channel = [data](const int index) {
+          return index < 0 ? uint8_t{ 0xff } : static_cast<uint8_t>(data[index]);
+        };
+        return { channel(R), channel(G), channel(B), channel(A) };
+      }
+
+#if VTFPARSER_SSE2
+      /**
+       * Permutes four pixels at once by shifting each source byte into place within its 32-bit lane.
+       */
+      static __m128i permute(const __m128i pixels) {
+        const auto byteMask = _mm_set1_epi32(0xff);
+        const auto move = [&]<int From, int To>() {
+          if constexpr (From < 0) {
+            return _mm_set1_epi32(static_cast<int>(0xffu << (To * 8)));
+          } else {
+            return _mm_slli_epi32(_mm_and_si128(_mm_srli_epi32(pixels, From * 8), byteMask), To * 8);
+          }
+        };
+
+        return _mm_or_si128(
+          _mm_or_si128(move.template operator()<R, 0>(), move.template operator()<G, 1>()),
+          _mm_or_si128(move.template operator()<B, 2>(), move.template operator()<A, 3>())
+        );
+      }
+#endif
+    };
+
+    /**
+     * Loader for 24-bit formats. Pure blue pixels become fully transparent in the bluescreen variants.
+     */
+    template<int R, int G, int B, bool Bluescreen>
+    struct Rgb24Kernel {
+      static constexpr bool SUPPORTED = true;
+      static constexpr size_t SIZE = 3;
+
+      static Rgba8 load(const std::byte* data) {
+        const Rgba8 pixel = {
+          static_cast<uint8_t>(data[R]), static_cast<uint8_t>(data[G]), static_cast<uint8_t>(data[B]), 0xff
+        };
+
+        if constexpr (Bluescreen) {
+          if (pixel[0] == 0 && pixel[1] == 0 && pixel[2] == 0xff) {
+            return { 0, 0, 0, 0 };
+          }
+        }
+
+        return pixel;
+      }
+    };
+
+    /**
+     * Loader for 16-bit packed formats. Each channel is given as its lowest bit and width, with a width of 0 for a
+     * channel which is always opaque.
+     */
+    template<unsigned RShift, unsigned RBits, unsigned GShift, unsigned GBits, unsigned BShift, unsigned BBits,
+      unsigned AShift, unsigned ABits>
+    struct Packed16Kernel {
+      static constexpr bool SUPPORTED = true;
+      static constexpr size_t SIZE = 2;
+
+      static Rgba8 load(const std::byte* data) {
+        const uint32_t value = read<uint16_t>(data);
+        const auto channel = []<unsigned Shift, unsigned Bits>(const uint32_t packed) -> uint8_t {
+          if constexpr (Bits == 0) {
+            return 0xff;
+          } else {
+            return expandBits<Bits>((packed >> Shift) & ((1u << Bits) - 1u));
+          }
+        };
+
+        return {
+          channel.template operator()<RShift, RBits>(value),
+          channel.template operator()<GShift, GBits>(value),
+          channel.template operator()<BShift, BBits>(value),
+          channel.template operator()<AShift, ABits>(value),
+        };
+      }
+    };
+
+    template<>
+    struct Kernel<ImageFormat::RGBA8888> : Swizzle32Kernel<0, 1, 2, 3> {};
+
+    template<>
+    struct Kernel<ImageFormat::ABGR8888> : Swizzle32Kernel<3, 2, 1, 0> {};
+
+    template<>
+    struct Kernel<ImageFormat::ARGB8888> : Swizzle32Kernel<1, 2, 3, 0> {};
+
+    template<>
+    struct Kernel<ImageFormat::BGRA8888> : Swizzle32Kernel<2, 1, 0, 3> {};
+
+    template<>
+    struct Kernel<ImageFormat::BGRX8888> : Swizzle32Kernel<2, 1, 0, -1> {};
+
+    template<>
+    struct Kernel<ImageFormat::UVWQ8888> : Swizzle32Kernel<0, 1, 2, 3> {};
+
+    template<>
+    struct Kernel<ImageFormat::UVLX8888> : Swizzle32Kernel<0, 1, 2, 3> {};
+
+    template<>
+    struct Kernel<ImageFormat::RGB888> : Rgb24Kernel<0, 1, 2, false> {};
+
+    template<>
+    struct Kernel<ImageFormat::BGR888> : Rgb24Kernel<2, 1, 0, false> {};
+
+    template<>
+    struct Kernel<ImageFormat::RGB888_BLUESCREEN> : Rgb24Kernel<0, 1, 2, true> {};
+
+    template<>
+    struct Kernel<ImageFormat::BGR888_BLUESCREEN> : Rgb24Kernel<2, 1, 0, true> {};
+
+    template<>
+    struct Kernel<ImageFormat::RGB565> : Packed16Kernel<0, 5, 5, 6, 11, 5, 0, 0> {};
+
+    template<>
+    struct Kernel<ImageFormat::BGR565> : Packed16Kernel<11, 5, 5, 6, 0, 5, 0, 0> {};
+
+    template<>
+    struct Kernel<ImageFormat::BGRX5551> : Packed16Kernel<10, 5, 5, 5, 0, 5, 0, 0> {};
+
+    template<>
+    struct Kernel<ImageFormat::BGRA5551> : Packed16Kernel<10, 5, 5, 5, 0, 5, 15, 1> {};
+
+    template<>
+    struct Kernel<ImageFormat::BGRA4444> : Packed16Kernel<8, 4, 4, 4, 0, 4, 12, 4> {};
+
+    template<>
+    struct Kernel<ImageFormat::I8> {
+      static constexpr bool SUPPORTED = true;
+      static constexpr size_t SIZE = 1;
+
+      static Rgba8 load(const std::byte* data) {
+        const auto intensity = static_cast<uint8_t>(data[0]);
+        return { intensity, intensity, intensity, 0xff };
+      }
+    };
+
+    template<>
+    struct Kernel<ImageFormat::IA88> {
+      static constexpr bool SUPPORTED = true;
+      static constexpr size_t SIZE = 2;
+
+      static Rgba8 load(const std::byte* data) {
+        const auto intensity = static_cast<uint8_t>(data[0]);
+        return { intensity, intensity, intensity, static_cast<uint8_t>(data[1]) };
+      }
+    };
+
+    template<>
+    struct Kernel<ImageFormat::A8> {
+      static constexpr bool SUPPORTED = true;
+      static constexpr size_t SIZE = 1;
+
+      static Rgba8 load(const std::byte* data) {
+        return { 0, 0, 0, static_cast<uint8_t>(data[0]) };
+      }
+    };
+
+    template<>
+    struct Kernel<ImageFormat::UV88> {
+      static constexpr bool SUPPORTED = true;
+      static constexpr size_t SIZE = 2;
+
+      static Rgba8 load(const std::byte* data) {
+        return { static_cast<uint8_t>(data[0]), static_cast<uint8_t>(data[1]), 0, 0xff };
+      }
+    };
+
+    template<>
+    struct Kernel<ImageFormat::RGBA16161616F> {
+      static constexpr bool SUPPORTED = true;
+      static constexpr size_t SIZE = 8;
+
+      static Rgba32f load(const std::byte* data) {
+        const auto halves = read<std::array<uint16_t, 4>>(data);
+        return { halfToFloat(halves[0]), halfToFloat(halves[1]), halfToFloat(halves[2]), halfToFloat(halves[3]) };
+      }
+    };
+
+    template<>
+    struct Kernel<ImageFormat::RGBA16161616> {
+      static constexpr bool SUPPORTED = true;
+      static constexpr size_t SIZE = 8;
+
+      static Rgba32f load(const std::byte* data) {
+        const auto channels = read<std::array<uint16_t, 4>>(data);
+        constexpr float scale = 1.0f / 65535.0f;
+        return {
+          static_cast<float>(channels[0]) * scale,
+          static_cast<float>(channels[1]) * scale,
+          static_cast<float>(channels[2]) * scale,
+          static_cast<float>(channels[3]) * scale,
+        };
+      }
+    };
+
+    template<typename K>
+    constexpr bool IS_SWIZZLE32 = requires { K::SWIZZLE32; };
+
+    template<typename K>
+    constexpr bool LOADS_FLOAT = std::is_same_v<decltype(K::load(nullptr)), Rgba32f>;
+
+    template<ImageFormat Format>
+    void convertToRgba8(const std::byte* source, std::byte* destination, const size_t pixelCount) {
+      using K = Kernel<Format>;
+      size_t i = 0;
+
+#if VTFPARSER_SSE2
+      if constexpr (IS_SWIZZLE32<K>) {
+        for (; i + 4 <= pixelCount; i += 4) {
+          const auto pixels = _mm_loadu_si128(reinterpret_cast<const __m128i*>(source + i * 4));
+          _mm_storeu_si128(reinterpret_cast<__m128i*>(destination + i * 4), K::permute(pixels));
+        }
+      }
+#endif
+
+      for (; i < pixelCount; i++) {
+        const auto pixel = K::load(source + i * K::SIZE);
+
+        if constexpr (LOADS_FLOAT<K>) {
+          const Rgba8 narrowed = {
+            floatToUnorm8(pixel[0]), floatToUnorm8(pixel[1]), floatToUnorm8(pixel[2]), floatToUnorm8(pixel[3])
+          };
+          std::memcpy(destination + i * 4, narrowed.data(), 4);
+        } else {
+          std::memcpy(destination + i * 4, pixel.data(), 4);
+        }
+      }
+    }
+
+    template<ImageFormat Format>
+    void convertToRgba32f(const std::byte* source, std::byte* destination, const size_t pixelCount) {
+      using K = Kernel<Format>;
+
+      if constexpr (LOADS_FLOAT<K>) {
+        for (size_t i = 0; i < pixelCount; i++) {
+          const auto pixel = K::load(source + i * K::SIZE);
+          std::memcpy(destination + i * sizeof(Rgba32f), pixel.data(), sizeof(Rgba32f));
+        }
+      } else {
+        // Normalise through RGBA8 in small batches, so the widening to float is shared by every 8-bit format
+        std::array<std::byte, STAGING_PIXELS * 4> staging;
+
+        for (size_t i = 0; i < pixelCount; i += STAGING_PIXELS) {
+          const auto count = std::min(STAGING_PIXELS, pixelCount - i);
+          convertToRgba8<Format>(source + i * K::SIZE, staging.data(), count);
+          widenRgba8ToRgba32f(staging.data(), destination + i * sizeof(Rgba32f), count);
+        }
+      }
+    }
+
+    template<template<ImageFormat> typename Converter, size_t... Indices>
+    constexpr std::array<PixelConverter, FORMAT_COUNT> makeConverterTable(std::index_sequence<Indices...>) {
+      return { []<ImageFormat Format>() -> PixelConverter {
+        if constexpr (Kernel<Format>::SUPPORTED) {
+          return &Converter<Format>::convert;
+        } else {
+          return nullptr;
+        }
+      }.template operator()<static_cast<ImageFormat>(Indices)>()... };
+    }
+
+    template<ImageFormat Format>
+    struct Rgba8Converter {
+      static void convert(const std::byte* source, std::byte* destination, const size_t pixelCount) {
+        convertToRgba8<Format>(source, destination, pixelCount);
+      }
+    };
+
+    template<ImageFormat Format>
+    struct Rgba32fConverter {
+      static void convert(const std::byte* source, std::byte* destination, const size_t pixelCount) {
+        convertToRgba32f<Format>(source, destination, pixelCount);
+      }
+    };
+
+    constexpr auto RGBA8_CONVERTERS = makeConverterTable<Rgba8Converter>(std::make_index_sequence<FORMAT_COUNT>());
+    constexpr auto RGBA32F_CONVERTERS = makeConverterTable<Rgba32fConverter>(std::make_index_sequence<FORMAT_COUNT>());
+
+    PixelConverter lookup(const std::array<PixelConverter, FORMAT_COUNT>& table, const ImageFormat format) {
+      const auto index = static_cast<size_t>(format);
+      return index < table.size() ? table[index] : nullptr;
+    }
+  }
+
+  PixelConverter getRgba8Converter(const ImageFormat format) {
+    return lookup(RGBA8_CONVERTERS, format);
+  }
+
+  PixelConverter getRgba32fConverter(const ImageFormat format) {
+    return lookup(RGBA32F_CONVERTERS, format);
+  }
+
+  void widenRgba8ToRgba32f(const std::byte* source, std::byte* destination, const size_t pixelCount) {
+    size_t i = 0;
+
+#if VTFPARSER_SSE2
+    const auto zero = _mm_setzero_si128();
+    const auto scale = _mm_set1_ps(INV_255);
+
+    for (; i + 4 <= pixelCount; i += 4) {
+      const auto bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(source + i * 4));
+      const auto low = _mm_unpacklo_epi8(bytes, zero);
+      const auto high = _mm_unpackhi_epi8(bytes, zero);
+
+      auto* output = reinterpret_cast<float*>(destination + i * sizeof(Rgba32f));
+      _mm_storeu_ps(output, _mm_mul_ps(_mm_cvtepi32_ps(_mm_unpacklo_epi16(low, zero)), scale));
+      _mm_storeu_ps(output + 4, _mm_mul_ps(_mm_cvtepi32_ps(_mm_unpackhi_epi16(low, zero)), scale));
+      _mm_storeu_ps(output + 8, _mm_mul_ps(_mm_cvtepi32_ps(_mm_unpacklo_epi16(high, zero)), scale));
+      _mm_storeu_ps(output + 12, _mm_mul_ps(_mm_cvtepi32_ps(_mm_unpackhi_epi16(high, zero)), scale));
+    }
+#endif
+
+    for (; i < pixelCount; i++) {
+      Rgba8 pixel;
+      std::memcpy(pixel.data(), source + i * 4, 4);
+
+      const Rgba32f widened = {
+        static_cast<float>(pixel[0]) * INV_255,
+        static_cast<float>(pixel[1]) * INV_255,
+        static_cast<float>(pixel[2]) * INV_255,
+        static_cast<float>(pixel[3]) * INV_255,
+      };
+      std::memcpy(destination + i * sizeof(Rgba32f), widened.data(), sizeof(Rgba32f));
+    }
+  }
+}
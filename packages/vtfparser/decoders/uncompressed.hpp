@@ -0,0 +1,40 @@
+#pragma once
+
+#include <cstddef>
+#include "../file-format-objects/enums.hpp"
+
+namespace VtfParser::Internal {
+  /**
+   * Converts a run of pixels from one format to another.
+   * @param source Source pixels, tightly packed.
+   * @param destination Destination pixels, tightly packed.
+   * @param pixelCount Number of pixels to convert.
+   */
+  using PixelConverter = void (*)(const std::byte* source, std::byte* destination, size_t pixelCount);
+
+  /**
+   * Gets the converter from an uncompressed format to RGBA8 (one byte per channel, in R, G, B, A order).
+   * @remark Converters are specialised per format at compile time and looked up from a table.
+   * @param format Source format.
+   * @return Converter, or nullptr if the format is block compressed or cannot be converted (e.g. P8).
+   */
+  [[nodiscard]] PixelConverter getRgba8Converter(ImageFormat format);
+
+  /**
+   * Gets the converter from an uncompressed format to RGBA32F (one float per channel, in R, G, B, A order).
+   * @remark Normalised formats are mapped to [0, 1]. RGBA16161616F keeps its full range.
+   * @param format Source format.
+   * @return Converter, or nullptr if the format is block compressed or cannot be converted (e.g. P8).
+   */
+  [[nodiscard]] PixelConverter getRgba32fConverter(ImageFormat format);
+
+  /**
+   * Widens RGBA8 pixels to RGBA32F, mapping each channel to [0, 1].
+   * @remark Each group of pixels is read before it is written, so the source may be the last quarter of the
+   * @remark destination buffer, allowing an RGBA8 image to be widened in place.
+   * @param source RGBA8 pixels.
+   * @param destination RGBA32F pixels.
+   * @param pixelCount Number of pixels to widen.
+   */
+  void widenRgba8ToRgba32f(const std::byte* source, std::byte* destination, size_t pixelCount);
+}
@@ -0,0 +1,598 @@
+#include "block-compressed.hpp"
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include "../helpers/rgb565.hpp"
+#include "../helpers/simd.hpp"
+
+namespace VtfParser::Internal {
+  namespace {
+    constexpr size_t BLOCK_DIMENSION = 4;
+    constexpr size_t BLOCK_PIXELS = BLOCK_DIMENSION * BLOCK_DIMENSION;
+    constexpr size_t DXT1_BLOCK_SIZE = 8;
+    constexpr size_t DXT5_BLOCK_SIZE = 16;
+
+    constexpr uint32_t COLOUR_MASK = 0x00ffffff;
+    constexpr uint8_t ONE_BIT_ALPHA_THRESHOLD = 128;
+
+    /**
+     * Number of least squares refinement passes used by BlockQuality::High.
+     */
+    constexpr int REFINE_ITERATIONS = 2;
+
+    /**
+     * A 4x4 block of RGBA8 pixels (as little-endian uint32s), row by row.
+     */
+    using PixelBlock = std::array<uint32_t, BLOCK_PIXELS>;
+    using Palette = std::array<uint32_t, 4>;
+
+    struct Rgb {
+      float r;
+      float g;
+      float b;
+    };
+
+    struct IndexFit {
+      uint32_t indices;
+      uint32_t error;
+    };
+
+    template<typename T>
+    void write(std::byte* data, const T value) {
+      std::memcpy(data, &value, sizeof(T));
+    }
+
+    uint32_t channel(const uint32_t pixel, const uint32_t index) {
+      return (pixel >> (index * 8)) & 0xffu;
+    }
+
+    /**
+     * Gathers a 4x4 block, repeating the last row and column for blocks which overhang the edge of the image.
+     */
+    void loadBlock(
+      const std::byte* pixels,
+      const uint32_t width,
+      const uint32_t height,
+      const size_t blockX,
+      const size_t blockY,
+      PixelBlock& block
+    ) {
+      for (size_t y = 0; y < BLOCK_DIMENSION; y++) {
+        const auto sourceY = std::min<size_t>(blockY * BLOCK_DIMENSION + y, height - 1);
+
+        for (size_t x = 0; x < BLOCK_DIMENSION; x++) {
+          const auto sourceX = std::min<size_t>(blockX * BLOCK_DIMENSION + x, width - 1);
+          std::memcpy(&block[y * BLOCK_DIMENSION + x], pixels + (sourceY * width + sourceX) * 4, 4);
+        }
+      }
+    }
+
+    uint16_t packRgb(const Rgb& colour) {
+      const auto clamp = [](const float value) {
+        return static_cast<uint32_t>(std::clamp(value, 0.0f, 255.0f) + 0.5f);
+      };
+
+      return pack565(clamp(colour.r), clamp(colour.g), clamp(colour.b));
+    }
+
+    /**
+     * Squared RGB distance of each pixel to each palette entry, choosing the closest entry for each pixel.
+     * @param block Pixels to fit.
+     * @param palette Candidate colours. Only the first paletteSize are considered.
+     * @param paletteSize 3 or 4.
+     * @param forcedMask Bit per pixel which is forced to index 3 (transparent) instead of being fitted.
+     */
+    IndexFit fitIndices(const PixelBlock& block, const Palette& palette, const int paletteSize, const uint32_t forcedMask) {
+      std::array<uint32_t, BLOCK_PIXELS> chosen{};
+      std::array<uint32_t, BLOCK_PIXELS> distances{};
+
+#if VTFPARSER_SSE2
+      const auto zero = _mm_setzero_si128();
+      const auto colourMask = _mm_set1_epi32(static_cast<int>(COLOUR_MASK));
+
+      // Squared distances of four pixels to one colour, as four int32 lanes
+      const auto distance = [&](const __m128i pixels, const __m128i colour) {
+        auto low = _mm_sub_epi16(_mm_unpacklo_epi8(pixels, zero), _mm_unpacklo_epi8(colour, zero));
+        auto high = _mm_sub_epi16(_mm_unpackhi_epi8(pixels, zero), _mm_unpackhi_epi8(colour, zero));
+        low = _mm_madd_epi16(low, low);
+        high = _mm_madd_epi16(high, high);
+
+        // Each pixel is now split across two lanes (r^2 + g^2 and b^2), so add the pairs back together
+        const auto first = _mm_castps_si128(
+          _mm_shuffle_ps(_mm_castsi128_ps(low), _mm_castsi128_ps(high), _MM_SHUFFLE(2, 0, 2, 0))
+        );
+        const auto second = _mm_castps_si128(
+          _mm_shuffle_ps(_mm_castsi128_ps(low), _mm_castsi128_ps(high), _MM_SHUFFLE(3, 1, 3, 1))
+        );
+        return _mm_add_epi32(first, second);
+      };
+
+      __m128i colours[4];
+      for (int i = 0; i < paletteSize; i++) {
+        colours[i] = _mm_and_si128(_mm_set1_epi32(static_cast<int>(palette[i])), colourMask);
+      }
+
+      for (size_t row = 0; row < BLOCK_DIMENSION; row++) {
+        const auto pixels = _mm_and_si128(
+          _mm_loadu_si128(reinterpret_cast<const __m128i*>(&block[row * BLOCK_DIMENSION])),
+          colourMask
+        );
+
+        auto best = distance(pixels, colours[0]);
+        auto bestIndex = zero;
+        for (int i = 1; i < paletteSize; i++) {
+          const auto candidate = distance(pixels, colours[i]);
+          const auto closer = _mm_cmplt_epi32(candidate, best);
+          best = _mm_or_si128(_mm_and_si128(closer, candidate), _mm_andnot_si128(closer, best));
+          bestIndex = _mm_or_si128(_mm_and_si128(closer, _mm_set1_epi32(i)), _mm_andnot_si128(closer, bestIndex));
+        }
+
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(&chosen[row * BLOCK_DIMENSION]), bestIndex);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(&distances[row * BLOCK_DIMENSION]), best);
+      }
+#else
+      for (size_t i = 0; i < BLOCK_PIXELS; i++) {
+        uint32_t best = std::numeric_limits<uint32_t>::max();
+        for (int candidate = 0; candidate < paletteSize; candidate++) {
+          uint32_t distance = 0;
+          for (uint32_t c = 0; c < 3; c++) {
+            const auto difference = static_cast<int>(channel(block[i], c)) - static_cast<int>(channel(palette[candidate], c));
+            distance += static_cast<uint32_t>(difference * difference);
+          }
+
+          if (distance < best) {
+            best = distance;
+            chosen[i] = static_cast<uint32_t>(candidate);
+          }
+        }
+        distances[i] = best;
+      }
+#endif
+
+      IndexFit fit{};
+      for (size_t i = 0; i < BLOCK_PIXELS; i++) {
+        if (forcedMask & (1u << i)) {
+          fit.indices |= 3u << (i * 2);
+          continue;
+        }
+
+        fit.indices |= chosen[i] << (i * 2);
+        fit.error += distances[i];
+      }
+
+      return fit;
+    }
+
+    /**
+     * Endpoints spanning the bounding box of the block's colours, inset slightly to reduce the error of the
+     * interpolated colours, as in van Waveren's real-time DXT compression.
+     */
+    std::pair<Rgb, Rgb> getBoundingBoxEndpoints(const PixelBlock& block, const uint32_t ignoredMask) {
+#if VTFPARSER_SSE2
+      // Ignored pixels are replaced with the first used one, so they can't widen the box
+      PixelBlock used = block;
+      const auto first = static_cast<size_t>(std::countr_one(ignoredMask));
+      for (size_t i = 0; i < BLOCK_PIXELS; i++) {
+        if (ignoredMask & (1u << i)) {
+          used[i] = block[first];
+        }
+      }
+
+      auto minimum = _mm_loadu_si128(reinterpret_cast<const __m128i*>(&used[0]));
+      auto maximum = minimum;
+      for (size_t row = 1; row < BLOCK_DIMENSION; row++) {
+        const auto pixels = _mm_loadu_si128(reinterpret_cast<const __m128i*>(&used[row * BLOCK_DIMENSION]));
+        minimum = _mm_min_epu8(minimum, pixels);
+        maximum = _mm_max_epu8(maximum, pixels);
+      }
+
+      // Reduce the four lanes down to one
+      minimum = _mm_min_epu8(minimum, _mm_shuffle_epi32(minimum, _MM_SHUFFLE(1, 0, 3, 2)));
+      minimum = _mm_min_epu8(minimum, _mm_shuffle_epi32(minimum, _MM_SHUFFLE(2, 3, 0, 1)));
+      maximum = _mm_max_epu8(maximum, _mm_shuffle_epi32(maximum, _MM_SHUFFLE(1, 0, 3, 2)));
+      maximum = _mm_max_epu8(maximum, _mm_shuffle_epi32(maximum, _MM_SHUFFLE(2, 3, 0, 1)));
+
+      const auto low = static_cast<uint32_t>(_mm_cvtsi128_si32(minimum));
+      const auto high = static_cast<uint32_t>(_mm_cvtsi128_si32(maximum));
+#else
+      uint32_t low = COLOUR_MASK;
+      uint32_t high = 0;
+      for (size_t i = 0; i < BLOCK_PIXELS; i++) {
+        if (ignoredMask & (1u << i)) {
+          continue;
+        }
+
+        uint32_t newLow = 0;
+        uint32_t newHigh = 0;
+        for (uint32_t c = 0; c < 3; c++) {
+          newLow |= std::min(channel(low, c), channel(block[i], c)) << (c * 8);
+          newHigh |= std::max(channel(high, c), channel(block[i], c)) << (c * 8);
+        }
+        low = newLow;
+        high = newHigh;
+      }
+#endif
+
+      Rgb minimumColour{};
+      Rgb maximumColour{};
+      for (uint32_t c = 0; c < 3; c++) {
+        const auto lowValue = static_cast<float>(channel(low, c));
+        const auto highValue = static_cast<float>(channel(high, c));
+        const auto inset = (highValue - lowValue) / 16.0f;
+
+        (&minimumColour.r)[c] = lowValue + inset;
+        (&maximumColour.r)[c] = highValue - inset;
+      }
+
+      return { maximumColour, minimumColour };
+    }
+
+    /**
+     * Endpoints at the extremes of the block's colours along their principal axis.
+     */
+    std::pair<Rgb, Rgb> getPrincipalAxisEndpoints(const PixelBlock& block, const uint32_t ignoredMask) {
+      Rgb mean{};
+      float count = 0;
+      for (size_t i = 0; i < BLOCK_PIXELS; i++) {
+        if (ignoredMask & (1u << i)) {
+          continue;
+        }
+
+        mean.r += static_cast<float>(channel(block[i], 0));
+        mean.g += static_cast<float>(channel(block[i], 1));
+        mean.b += static_cast<float>(channel(block[i], 2));
+        count++;
+      }
+      mean = { mean.r / count, mean.g / count, mean.b / count };
+
+      // Covariance matrix, stored as its upper triangle: rr, rg, rb, gg, gb, bb
+      std::array<float, 6> covariance{};
+      for (size_t i = 0; i < BLOCK_PIXELS; i++) {
+        if (ignoredMask & (1u << i)) {
+          continue;
+        }
+
+        const auto r = static_cast<float>(channel(block[i], 0)) - mean.r;
+        const auto g = static_cast<float>(channel(block[i], 1)) - mean.g;
+        const auto b = static_cast<float>(channel(block[i], 2)) - mean.b;
+        covariance[0] += r * r;
+        covariance[1] += r * g;
+        covariance[2] += r * b;
+        covariance[3] += g * g;
+        covariance[4] += g * b;
+        covariance[5] += b * b;
+      }
+
+      // Power iteration converges on the dominant eigenvector, which is the principal axis
+      Rgb axis = { 1.0f, 1.0f, 1.0f };
+      for (int iteration = 0; iteration < 8; iteration++) {
+        const Rgb next = {
+          axis.r * covariance[0] + axis.g * covariance[1] + axis.b * covariance[2],
+          axis.r * covariance[1] + axis.g * covariance[3] + axis.b * covariance[4],
+          axis.r * covariance[2] + axis.g * covariance[4] + axis.b * covariance[5],
+        };
+
+        const auto length = std::max({ std::abs(next.r), std::abs(next.g), std::abs(next.b) });
+        if (length < 1e-6f) {
+          break;
+        }
+        axis = { next.r / length, next.g / length, next.b / length };
+      }
+
+      float minimum = std::numeric_limits<float>::max();
+      float maximum = std::numeric_limits<float>::lowest();
+      for (size_t i = 0; i < BLOCK_PIXELS; i++) {
+        if (ignoredMask & (1u << i)) {
+          continue;
+        }
+
+        const auto projection = (static_cast<float>(channel(block[i], 0)) - mean.r) * axis.r +
+          (static_cast<float>(channel(block[i], 1)) - mean.g) * axis.g +
+          (static_cast<float>(channel(block[i], 2)) - mean.b) * axis.b;
+        minimum = std::min(minimum, projection);
+        maximum = std::max(maximum, projection);
+      }
+
+      const auto along = [&](const float t) {
+        return Rgb{ mean.r + axis.r * t, mean.g + axis.g * t, mean.b + axis.b * t };
+      };
+      return { along(maximum), along(minimum) };
+    }
+
+    /**
+     * Solves for the endpoints which best reproduce the block with the given indices, in the least squares sense.
+     * @return Whether the fit was well conditioned enough to use.
+     */
+    bool refineEndpoints(
+      const PixelBlock& block,
+      const uint32_t indices,
+      const bool threeColour,
+      const uint32_t ignoredMask,
+      Rgb& first,
+      Rgb& second
+    ) {
+      // Weight of the first endpoint for each index
+      constexpr std::array<float, 4> FOUR_COLOUR_WEIGHTS = { 1.0f, 0.0f, 2.0f / 3.0f, 1.0f / 3.0f };
+      constexpr std::array<float, 4> THREE_COLOUR_WEIGHTS = { 1.0f, 0.0f, 0.5f, 0.0f };
+      const auto& weights = threeColour ? THREE_COLOUR_WEIGHTS : FOUR_COLOUR_WEIGHTS;
+
+      float aa = 0;
+      float ab = 0;
+      float bb = 0;
+      Rgb ax{};
+      Rgb bx{};
+      for (size_t i = 0; i < BLOCK_PIXELS; i++) {
+        if (ignoredMask & (1u << i)) {
+          continue;
+        }
+
+        const auto a = weights[(indices >> (i * 2)) & 0x3u];
+        const auto b = 1.0f - a;
+        const Rgb x = {
+          static_cast<float>(channel(block[i], 0)),
+          static_cast<float>(channel(block[i], 1)),
+          static_cast<float>(channel(block[i], 2)),
+        };
+
+        aa += a * a;
+        ab += a * b;
+        bb += b * b;
+        ax = { ax.r + a * x.r, ax.g + a * x.g, ax.b + a * x.b };
+        bx = { bx.r + b * x.r, bx.g + b * x.g, bx.b + b * x.b };
+      }
+
+      const auto determinant = aa * bb - ab * ab;
+      if (std::abs(determinant) < 1e-6f) {
+        return false;
+      }
+
+      const auto scale = 1.0f / determinant;
+      first = {
+        (ax.r * bb - bx.r * ab) * scale,
+        (ax.g * bb - bx.g * ab) * scale,
+        (ax.b * bb - bx.b * ab) * scale,
+      };
+      second = {
+        (bx.r * aa - ax.r * ab) * scale,
+        (bx.g * aa - ax.g * ab) * scale,
+        (bx.b * aa - ax.b * ab) * scale,
+      };
+
+      return true;
+    }
+
+    struct ColourBlock {
+      uint16_t c0;
+      uint16_t c1;
+      IndexFit fit;
+    };
+
+    /**
+     * Orders the endpoints for the wanted mode and fits indices to them.
+     */
+    ColourBlock fitColourBlock(
+      const PixelBlock& block,
+      uint16_t c0,
+      uint16_t c1,
+      const bool threeColour,
+      const uint32_t transparentMask
+    ) {
+      if (threeColour) {
+        // Three colour mode is selected by c0 <= c1
+        if (c0 > c1) {
+          std::swap(c0, c1);
+        }
+
+        return { c0, c1, fitIndices(block, getDxtPalette(c0, c1, true, 0), 3, transparentMask) };
+      }
+
+      if (c0 < c1) {
+        std::swap(c0, c1);
+      }
+      if (c0 == c1) {
+        // Equal endpoints would select three colour mode in DXT1, so only index 0 is safe to use
+        return { c0, c1, fitIndices(block, getDxtPalette(c0, c1, false, 0), 1, 0) };
+      }
+
+      return { c0, c1, fitIndices(block, getDxtPalette(c0, c1, false, 0), 4, 0) };
+    }
+
+    void encodeColourBlock(
+      const PixelBlock& block,
+      const bool allowTransparency,
+      const BlockQuality quality,
+      std::byte* output
+    ) {
+      uint32_t transparentMask = 0;
+      if (allowTransparency) {
+        for (size_t i = 0; i < BLOCK_PIXELS; i++) {
+          if (channel(block[i], 3) < ONE_BIT_ALPHA_THRESHOLD) {
+            transparentMask |= 1u << i;
+          }
+        }
+      }
+
+      if (transparentMask == 0xffff) {
+        write<uint16_t>(output, 0);
+        write<uint16_t>(output + 2, 0);
+        write<uint32_t>(output + 4, 0xffffffff);
+        return;
+      }
+
+      const auto threeColour = transparentMask != 0;
+      const auto [first, second] = quality == BlockQuality::Fast ?
+                                     getBoundingBoxEndpoints(block, transparentMask) :
+                                     getPrincipalAxisEndpoints(block, transparentMask);
+
+      auto best = fitColourBlock(block, packRgb(first), packRgb(second), threeColour, transparentMask);
+
+      if (quality == BlockQuality::High) {
+        for (int iteration = 0; iteration < REFINE_ITERATIONS && best.fit.error > 0; iteration++) {
+          Rgb refinedFirst{};
+          Rgb refinedSecond{};
+          if (!refineEndpoints(block, best.fit.indices, threeColour, transparentMask, refinedFirst, refinedSecond)) {
+            break;
+          }
+
+          const auto candidate = fitColourBlock(
+            block,
+            packRgb(refinedFirst),
+            packRgb(refinedSecond),
+            threeColour,
+            transparentMask
+          );
+          if (candidate.fit.error >= best.fit.error) {
+            break;
+          }
+          best = candidate;
+        }
+      }
+
+      write(output, best.c0);
+      write(output + 2, best.c1);
+      write(output + 4, best.fit.indices);
+    }
+
+    struct AlphaBlock {
+      uint8_t a0;
+      uint8_t a1;
+      uint64_t indices;
+      uint32_t error;
+    };
+
+    AlphaBlock fitAlphaBlock(const std::array<uint8_t, BLOCK_PIXELS>& alphas, const uint8_t a0, const uint8_t a1) {
+      std::array<int, 8> palette{ a0, a1 };
+      if (a0 > a1) {
+        for (int i = 1; i < 7; i++) {
+          palette[i + 1] = ((7 - i) * a0 + i * a1) / 7;
+        }
+      } else {
+        for (int i = 1; i < 5; i++) {
+          palette[i + 1] = ((5 - i) * a0 + i * a1) / 5;
+        }
+        palette[6] = 0;
+        palette[7] = 255;
+      }
+
+      AlphaBlock block{ a0, a1, 0, 0 };
+      for (size_t i = 0; i < BLOCK_PIXELS; i++) {
+        uint64_t bestIndex = 0;
+        auto bestError = std::numeric_limits<int>::max();
+        for (size_t candidate = 0; candidate < palette.size(); candidate++) {
+          const auto difference = static_cast<int>(alphas[i]) - palette[candidate];
+          if (difference * difference < bestError) {
+            bestError = difference * difference;
+            bestIndex = candidate;
+          }
+        }
+
+        block.indices |= bestIndex << (i * 3);
+        block.error += static_cast<uint32_t>(bestError);
+      }
+
+      return block;
+    }
+
+    void encodeAlphaBlock(const PixelBlock& block, const BlockQuality quality, std::byte* output) {
+      std::array<uint8_t, BLOCK_PIXELS> alphas{};
+      for (size_t i = 0; i < BLOCK_PIXELS; i++) {
+        alphas[i] = static_cast<uint8_t>(channel(block[i], 3));
+      }
+
+      const auto [minimum, maximum] = std::ranges::minmax(alphas);
+      auto best = fitAlphaBlock(alphas, maximum, minimum);
+
+      if (quality == BlockQuality::High && best.error > 0) {
+        // Six value mode has exact 0 and 255, so its endpoints only need to span the values in between
+        uint8_t innerMinimum = 255;
+        uint8_t innerMaximum = 0;
+        for (const auto alpha : alphas) {
+          if (alpha != 0 && alpha != 255) {
+            innerMinimum = std::min(innerMinimum, alpha);
+            innerMaximum = std::max(innerMaximum, alpha);
+          }
+        }
+
+        if (innerMinimum <= innerMaximum) {
+          const auto candidate = fitAlphaBlock(alphas, innerMinimum, innerMaximum);
+          if (candidate.error < best.error) {
+            best = candidate;
+          }
+        }
+      }
+
+      output[0] = static_cast<std::byte>(best.a0);
+      output[1] = static_cast<std::byte>(best.a1);
+      std::memcpy(output + 2, &best.indices, 6);
+    }
+
+    /**
+     * Walks every block of the image, loading each from the source pixels and encoding it with encodeBlock.
+     */
+    template<size_t BlockSize, typename EncodeBlock>
+    void encodeBlocks(
+      const std::span<const std::byte> pixels,
+      const uint32_t width,
+      const uint32_t height,
+      const std::span<std::byte> output,
+      const EncodeBlock& encodeBlock
+    ) {
+      const size_t blocksWide = (width + 3) / BLOCK_DIMENSION;
+      const size_t blocksHigh = (height + 3) / BLOCK_DIMENSION;
+
+      PixelBlock block;
+      for (size_t blockY = 0; blockY < blocksHigh; blockY++) {
+        for (size_t blockX = 0; blockX < blocksWide; blockX++) {
+          loadBlock(pixels.data(), width, height, blockX, blockY, block);
+          encodeBlock(block, &output[(blockY * blocksWide + blockX) * BlockSize]);
+        }
+      }
+    }
+  }
+
+  size_t getCompressedSizeBytes(const uint32_t width, const uint32_t height, const size_t blockSize) {
+    return ((static_cast<size_t>(width) + 3) / BLOCK_DIMENSION) * ((static_cast<size_t>(height) + 3) / BLOCK_DIMENSION) *
+      blockSize;
+  }
+
+  void encodeDxt1(
+    const std::span<const std::byte> pixels,
+    const uint32_t width,
+    const uint32_t height,
+    const bool oneBitAlpha,
+    const BlockQuality quality,
+    const std::span<std::byte> output
+  ) {
+    encodeBlocks<DXT1_BLOCK_SIZE>(
+      pixels,
+      width,
+      height,
+      output,
+      [oneBitAlpha, quality](const PixelBlock& block, std::byte* data) {
+        encodeColourBlock(block, oneBitAlpha, quality, data);
+      }
+    );
+  }
+
+  void encodeDxt5(
+    const std::span<const std::byte> pixels,
+    const uint32_t width,
+    const uint32_t height,
+    const BlockQuality quality,
+    const std::span<std::byte> output
+  ) {
+    encodeBlocks<DXT5_BLOCK_SIZE>(
+      pixels,
+      width,
+      height,
+      output,
+      [quality](const PixelBlock& block, std::byte* data) {
+        encodeAlphaBlock(block, quality, data);
+        encodeColourBlock(block, false, quality, data + 8);
+      }
+    );
+  }
+}
@@ -0,0 +1,68 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+namespace VtfParser::Internal {
+  /**
+   * How much effort to spend choosing block endpoints.
+   */
+  enum class BlockQuality : uint8_t {
+    /**
+     * Endpoints from the bounding box of the block's colours.
+     */
+    Fast,
+    /**
+     * Endpoints from the principal axis of the block's colours.
+     */
+    Normal,
+    /**
+     * Principal axis endpoints, refined by least squares fitting to the chosen indices.
+     */
+    High
+  };
+
+  /**
+   * Gets the size of an image once compressed to blocks of the given size.
+   * @param width Width of the image in pixels.
+   * @param height Height of the image in pixels.
+   * @param blockSize Size of each 4x4 block in bytes.
+   * @return Size of the compressed image in bytes.
+   */
+  [[nodiscard]] size_t getCompressedSizeBytes(uint32_t width, uint32_t height, size_t blockSize);
+
+  /**
+   * Compresses tightly packed RGBA8 pixels to DXT1 (BC1) blocks.
+   * @param pixels Source pixels.
+   * @param width Width of the image in pixels.
+   * @param height Height of the image in pixels.
+   * @param oneBitAlpha Whether pixels with alpha below 128 are encoded as transparent, using three colour blocks.
+   * @param quality Endpoint selection effort.
+   * @param output Destination for the blocks, row by row.
+   */
+  void encodeDxt1(
+    std::span<const std::byte> pixels,
+    uint32_t width,
+    uint32_t height,
+    bool oneBitAlpha,
+    BlockQuality quality,
+    std::span<std::byte> output
+  );
+
+  /**
+   * Compresses tightly packed RGBA8 pixels to DXT5 (BC3) blocks.
+   * @param pixels Source pixels.
+   * @param width Width of the image in pixels.
+   * @param height Height of the image in pixels.
+   * @param quality Endpoint selection effort.
+   * @param output Destination for the blocks, row by row.
+   */
+  void encodeDxt5(
+    std::span<const std::byte> pixels,
+    uint32_t width,
+    uint32_t height,
+    BlockQuality quality,
+    std::span<std::byte> output
+  );
+}
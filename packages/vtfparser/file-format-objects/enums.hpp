@@ -176,10 +176,10 @@ namespace VtfParser {
   };
 
   inline TextureFlags operator&(const TextureFlags& a, const TextureFlags& b) {
-    return static_cast<TextureFlags>(static_cast<uint8_t>(a) & static_cast<uint8_t>(b));
+    return static_cast<TextureFlags>(static_cast<uint32_t>(a) & static_cast<uint32_t>(b));
   }
 
   inline TextureFlags operator|(const TextureFlags& a, const TextureFlags& b) {
-    return static_cast<TextureFlags>(static_cast<uint8_t>(a) & static_cast<uint8_t>(b));
+    return static_cast<TextureFlags>(static_cast<uint32_t>(a) | static_cast<uint32_t>(b));
   }
 }
@@ -0,0 +1,71 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+
+namespace VtfParser {
+  /**
+   * Three-byte tags identifying the standard resources of VTF 7.3+.
+   */
+  namespace ResourceTags {
+    /**
+     * Low resolution (thumbnail) image data.
+     */
+    constexpr std::array<uint8_t, 3> LOW_RES_IMAGE = { 0x01, 0, 0 };
+    /**
+     * Sheet data describing the sequences and frames of an animated sprite.
+     */
+    constexpr std::array<uint8_t, 3> SHEET = { 0x10, 0, 0 };
+    /**
+     * High resolution image data.
+     */
+    constexpr std::array<uint8_t, 3> HIGH_RES_IMAGE = { 0x30, 0, 0 };
+    /**
+     * CRC32 of the source image.
+     */
+    constexpr std::array<uint8_t, 3> CRC = { 'C', 'R', 'C' };
+    /**
+     * Texture LOD control (resolution clamps).
+     */
+    constexpr std::array<uint8_t, 3> LOD_CONTROL = { 'L', 'O', 'D' };
+    /**
+     * Texture settings extended flags.
+     */
+    constexpr std::array<uint8_t, 3> EXTENDED_FLAGS = { 'T', 'S', 'O' };
+    /**
+     * Arbitrary key-value (VDF) text.
+     */
+    constexpr std::array<uint8_t, 3> KEY_VALUE_DATA = { 'K', 'V', 'D' };
+  }
+
+  /**
+   * Resource entry flag set when the resource has no data chunk, and the entry's data field holds its value directly.
+   */
+  constexpr uint8_t RESOURCE_FLAG_NO_DATA_CHUNK = 0x02;
+
+#pragma pack(push, 1)
+
+  /**
+   * Value of the LOD control resource, stored directly in the resource entry.
+   */
+  struct LodControlResource {
+    /**
+     * Highest mip resolution (as a power of 2) to use on the U axis.
+     */
+    uint8_t resolutionClampU;
+    /**
+     * Highest mip resolution (as a power of 2) to use on the V axis.
+     */
+    uint8_t resolutionClampV;
+    /**
+     * Resolution clamp on the U axis for Xbox 360.
+     */
+    uint8_t resolutionClampX360U;
+    /**
+     * Resolution clamp on the V axis for Xbox 360.
+     */
+    uint8_t resolutionClampX360V;
+  };
+
+#pragma pack(pop)
+}
@@ -0,0 +1,122 @@
+#include "image-sizes.hpp"
+#include <algorithm>
+#include <source-parsers-shared/errors.hpp>
+
+namespace VtfParser::Internal {
+  using namespace SourceParsers::Errors;
+
+  bool isBlockCompressed(const ImageFormat format) {
+    switch (format) {
+      case ImageFormat::DXT1:
+      case ImageFormat::DXT1_ONEBITALPHA:
+      case ImageFormat::DXT3:
+      case ImageFormat::DXT5:
+        return true;
+      default:
+        return false;
+    }
+  }
+
+  size_t getBlockSizeBytes(const ImageFormat format) {
+    switch (format) {
+      case ImageFormat::DXT1:
+      case ImageFormat::DXT1_ONEBITALPHA:
+        return 8;
+      case ImageFormat::DXT3:
+      case ImageFormat::DXT5:
+        return 16;
+      default:
+        throw InvalidHeader("Image format is not block compressed");
+    }
+  }
+
+  size_t getPixelSizeBytes(const ImageFormat format) {
+    switch (format) {
+      case ImageFormat::RGBA16161616F:
+      case ImageFormat::RGBA16161616:
+        return 8;
+      case ImageFormat::RGBA8888:
+      case ImageFormat::ABGR8888:
+      case ImageFormat::ARGB8888:
+      case ImageFormat::BGRA8888:
+      case ImageFormat::BGRX8888:
+      case ImageFormat::UVWQ8888:
+      case ImageFormat::UVLX8888:
+        return 4;
+      case ImageFormat::RGB888:
+      case ImageFormat::BGR888:
+      case ImageFormat::RGB888_BLUESCREEN:
+      case ImageFormat::BGR888_BLUESCREEN:
+        return 3;
+      case ImageFormat::RGB565:
+      case ImageFormat::IA88:
+      case ImageFormat::BGR565:
+      case ImageFormat::BGRX5551:
+      case ImageFormat::BGRA4444:
+      case ImageFormat::BGRA5551:
+      case ImageFormat::UV88:
+        return 2;
+      case ImageFormat::I8:
+      case ImageFormat::P8:
+      case ImageFormat::A8:
+        return 1;
+      default:
+        throw InvalidHeader("Unrecognised image format");
+    }
+  }
+
+  size_t getSliceSizeBytes(const ImageSizeInfo& sizeInfo) {
+    if (isBlockCompressed(sizeInfo.format)) {
+      const auto width = std::max<size_t>(sizeInfo.width, 4);
+      const auto height = std::max<size_t>(sizeInfo.height, 4);
+
+      return ((width + 3u) >> 2u) * ((height + 3u) >> 2u) * getBlockSizeBytes(sizeInfo.format);
+    }
+
+    return sizeInfo.width * sizeInfo.height * getPixelSizeBytes(sizeInfo.format);
+  }
+
+  size_t getFaceSizeBytes(const ImageSizeInfo& sizeInfo) {
+    return getSliceSizeBytes(sizeInfo) * sizeInfo.depth;
+  }
+
+  size_t getFrameSizeBytes(const ImageSizeInfo& sizeInfo) {
+    return getFaceSizeBytes(sizeInfo) * sizeInfo.faces;
+  }
+
+  size_t getMipSizeBytes(const ImageSizeInfo& sizeInfo) {
+    return getFrameSizeBytes(sizeInfo) * sizeInfo.frames;
+  }
+
+  size_t getImageSizeBytes(const ImageSizeInfo& sizeInfo) {
+    if (sizeInfo.format == ImageFormat::NONE) {
+      return 0;
+    }
+
+    size_t size = 0;
+    for (uint8_t mipLevel = 0; mipLevel < sizeInfo.mipLevels; mipLevel++) {
+      size += getMipSizeBytes(getMipSizeInfo(sizeInfo, mipLevel));
+    }
+
+    return size;
+  }
+
+  ImageSizeInfo getMipSizeInfo(const ImageSizeInfo& sizeInfo, const uint8_t mipLevel) {
+    auto mipSizeInfo = sizeInfo;
+    mipSizeInfo.width = std::max<size_t>(sizeInfo.width >> mipLevel, 1ul);
+    mipSizeInfo.height = std::max<size_t>(sizeInfo.height >> mipLevel, 1ul);
+    mipSizeInfo.depth = std::max<size_t>(sizeInfo.depth >> mipLevel, 1ul);
+    mipSizeInfo.mipLevels = 1;
+
+    return mipSizeInfo;
+  }
+
+  size_t getMipOffsetBytes(const ImageSizeInfo& sizeInfo, const uint8_t mipLevel) {
+    size_t offset = 0;
+    for (auto smallerMip = static_cast<uint8_t>(mipLevel + 1); smallerMip < sizeInfo.mipLevels; smallerMip++) {
+      offset += getMipSizeBytes(getMipSizeInfo(sizeInfo, smallerMip));
+    }
+
+    return offset;
+  }
+}
@@ -0,0 +1,66 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include "../file-format-objects/enums.hpp"
+
+namespace VtfParser::Internal {
+  struct ImageSizeInfo {
+    ImageFormat format;
+    size_t width;
+    size_t height;
+    size_t depth;
+    size_t faces;
+    size_t frames;
+    uint8_t mipLevels;
+  };
+
+  /**
+   * Returns whether the format is stored as 4x4 compressed blocks (DXT1, DXT3 or DXT5).
+   * @param format
+   * @return True for block compressed formats.
+   */
+  [[nodiscard]] bool isBlockCompressed(ImageFormat format);
+
+  /**
+   * Returns the number of bytes used by each 4x4 block of the given format.
+   * @remark Only works with block compressed formats.
+   * @param format
+   * @return Size of each block in bytes.
+   */
+  [[nodiscard]] size_t getBlockSizeBytes(ImageFormat format);
+
+  /**
+   * Returns the number of bytes used by each pixel of the given format.
+   * @remark Only works with uncompressed formats.
+   * @param format
+   * @return Size of each pixel in bytes.
+   */
+  [[nodiscard]] size_t getPixelSizeBytes(ImageFormat format);
+
+  [[nodiscard]] size_t getSliceSizeBytes(const ImageSizeInfo& sizeInfo);
+
+  [[nodiscard]] size_t getFaceSizeBytes(const ImageSizeInfo& sizeInfo);
+
+  [[nodiscard]] size_t getFrameSizeBytes(const ImageSizeInfo& sizeInfo);
+
+  [[nodiscard]] size_t getMipSizeBytes(const ImageSizeInfo& sizeInfo);
+
+  [[nodiscard]] size_t getImageSizeBytes(const ImageSizeInfo& sizeInfo);
+
+  /**
+   * Returns the size info of a single mip level, with the extent halved once per level down to a minimum of 1.
+   * @param sizeInfo Size info of the whole image.
+   * @param mipLevel
+   * @return Size info of the mip level, with mipLevels set to 1.
+   */
+  [[nodiscard]] ImageSizeInfo getMipSizeInfo(const ImageSizeInfo& sizeInfo, uint8_t mipLevel);
+
+  /**
+   * Returns the offset of a mip level within the image data, where mip levels are stored smallest first.
+   * @param sizeInfo Size info of the whole image.
+   * @param mipLevel
+   * @return Offset of the mip level in bytes.
+   */
+  [[nodiscard]] size_t getMipOffsetBytes(const ImageSizeInfo& sizeInfo, uint8_t mipLevel);
+}
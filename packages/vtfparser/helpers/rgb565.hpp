@@ -0,0 +1,68 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+
+namespace VtfParser::Internal {
+  /**
+   * Expands a 565 colour to RGBA8 (as a little-endian uint32) with opaque alpha.
+   * Each channel's high bits are replicated into its low bits, so 0 and the channel maximum map exactly to 0 and 255.
+   */
+  constexpr uint32_t expand565(const uint16_t colour) {
+    const uint32_t r = (colour >> 11u) & 0x1fu;
+    const uint32_t g = (colour >> 5u) & 0x3fu;
+    const uint32_t b = colour & 0x1fu;
+
+    return ((r << 3u) | (r >> 2u)) | ((g << 2u) | (g >> 4u)) << 8u | ((b << 3u) | (b >> 2u)) << 16u | 0xff000000u;
+  }
+
+  /**
+   * Packs 8-bit channels into a 565 colour, rounding to the nearest representable value.
+   */
+  constexpr uint16_t pack565(const uint32_t r, const uint32_t g, const uint32_t b) {
+    return static_cast<uint16_t>((r * 31 + 127) / 255 << 11u | (g * 63 + 127) / 255 << 5u | (b * 31 + 127) / 255);
+  }
+
+  /**
+   * Blends the RGB channels of two colours as (a * weightA + b * weightB) / divisor, with opaque alpha.
+   */
+  constexpr uint32_t blendRgb(
+    const uint32_t a,
+    const uint32_t b,
+    const uint32_t weightA,
+    const uint32_t weightB,
+    const uint32_t divisor
+  ) {
+    uint32_t result = 0xff000000u;
+    for (uint32_t shift = 0; shift < 24; shift += 8) {
+      const auto channel = (((a >> shift) & 0xffu) * weightA + ((b >> shift) & 0xffu) * weightB) / divisor;
+      result |= channel << shift;
+    }
+
+    return result;
+  }
+
+  /**
+   * Builds the palette of a DXT colour block from its two 565 endpoints.
+   * @param c0 First endpoint.
+   * @param c1 Second endpoint.
+   * @param allowThreeColour Whether c0 <= c1 selects three colour mode (DXT1 only).
+   * @param transparent Colour to use for index 3 in three colour mode.
+   * @return Colours selected by indices 0 to 3.
+   */
+  constexpr std::array<uint32_t, 4> getDxtPalette(
+    const uint16_t c0,
+    const uint16_t c1,
+    const bool allowThreeColour,
+    const uint32_t transparent
+  ) {
+    const auto p0 = expand565(c0);
+    const auto p1 = expand565(c1);
+
+    if (!allowThreeColour || c0 > c1) {
+      return { p0, p1, blendRgb(p0, p1, 2, 1, 3), blendRgb(p0, p1, 1, 2, 3) };
+    }
+
+    return { p0, p1, blendRgb(p0, p1, 1, 1, 2), transparent };
+  }
+}
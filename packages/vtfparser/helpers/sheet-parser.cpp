@@ -0,0 +1,87 @@
+#include "sheet-parser.hpp"
+#include <cstring>
+#include <source-parsers-shared/errors.hpp>
+#include <source-parsers-shared/internal/check-bounds.hpp>
+
+namespace VtfParser::Internal {
+  using namespace SourceParsers::Errors;
+  using namespace SourceParsers::Internal;
+
+  namespace {
+    constexpr uint32_t MAX_SHEET_VERSION = 1;
+    constexpr uint8_t VERSION_1_IMAGES_PER_FRAME = 4;
+
+    /**
+     * Reads consecutive little-endian values from the sheet data, checking each read is in bounds.
+     */
+    class SheetReader {
+    public:
+      explicit SheetReader(const std::span<const std::byte> data) : data(data) {}
+
+      template<typename T>
+      T read() {
+        checkBounds(static_cast<int64_t>(offset), sizeof(T), data.size(), "VTF sheet data is truncated");
+
+        T value;
+        std::memcpy(&value, data.data() + offset, sizeof(T));
+        offset += sizeof(T);
+
+        return value;
+      }
+
+      [[nodiscard]] size_t getRemaining() const {
+        return data.size() - offset;
+      }
+
+    private:
+      std::span<const std::byte> data;
+      size_t offset = 0;
+    };
+  }
+
+  Sheet parseSheet(const std::span<const std::byte> data) {
+    SheetReader reader(data);
+
+    Sheet sheet{};
+    sheet.version = reader.read<uint32_t>();
+    if (sheet.version > MAX_SHEET_VERSION) {
+      throw InvalidBody("VTF sheet version is not supported");
+    }
+    sheet.imagesPerFrame = sheet.version == 0 ? 1 : VERSION_1_IMAGES_PER_FRAME;
+
+    const auto sequenceCount = reader.read<uint32_t>();
+    // Every sequence has a 16 byte header, so a count larger than this can't be valid and isn't worth reserving for
+    if (sequenceCount > reader.getRemaining() / 16) {
+      throw OutOfBoundsAccess("VTF sheet data is truncated");
+    }
+    sheet.sequences.reserve(sequenceCount);
+
+    const auto frameSizeBytes = sizeof(float) + sheet.imagesPerFrame * sizeof(SheetImageRect);
+
+    for (uint32_t i = 0; i < sequenceCount; i++) {
+      SheetSequence sequence{};
+      sequence.sequenceNumber = reader.read<uint32_t>();
+      sequence.clamp = reader.read<uint32_t>() != 0;
+      sequence.frameCount = reader.read<uint32_t>();
+      sequence.totalTime = reader.read<float>();
+      sequence.firstFrame = sheet.frames.size();
+
+      if (sequence.frameCount > reader.getRemaining() / frameSizeBytes) {
+        throw OutOfBoundsAccess("VTF sheet data is truncated");
+      }
+      for (size_t frameIndex = 0; frameIndex < sequence.frameCount; frameIndex++) {
+        SheetFrame frame{};
+        frame.duration = reader.read<float>();
+        for (uint8_t image = 0; image < sheet.imagesPerFrame; image++) {
+          frame.images[image] = reader.read<SheetImageRect>();
+        }
+
+        sheet.frames.push_back(frame);
+      }
+
+      sheet.sequences.push_back(sequence);
+    }
+
+    return sheet;
+  }
+}
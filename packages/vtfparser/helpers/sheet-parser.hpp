@@ -0,0 +1,16 @@
+#pragma once
+
+#include <cstddef>
+#include <span>
+#include "../sheet.hpp"
+
+namespace VtfParser::Internal {
+  /**
+   * Decodes the data chunk of a sheet resource.
+   * @param data Sheet resource data, excluding its size prefix.
+   * @return Decoded sheet.
+   * @throws Errors::InvalidBody The sheet version is unknown.
+   * @throws Errors::OutOfBoundsAccess The data is truncated.
+   */
+  [[nodiscard]] Sheet parseSheet(std::span<const std::byte> data);
+}
@@ -0,0 +1,9 @@
+#pragma once
+
+// SSE2 is part of the x86-64 baseline, so it can be used without runtime detection or extra compiler flags
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define VTFPARSER_SSE2 1
+#include <emmintrin.h>
+#else
+#define VTFPARSER_SSE2 0
+#endif
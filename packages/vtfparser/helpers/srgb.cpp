@@ -0,0 +1,54 @@
+#include "srgb.hpp"
+#include <algorithm>
+#include <array>
+#include <cmath>
+
+namespace VtfParser::Internal {
+  namespace {
+    double decode(const double srgb) {
+      return srgb <= 0.04045 ? srgb / 12.92 : std::pow((srgb + 0.055) / 1.055, 2.4);
+    }
+
+    const std::array<float, 256>& getLinearTable() {
+      static const auto table = [] {
+        std::array<float, 256> values{};
+        for (size_t i = 0; i < values.size(); i++) {
+          values[i] = static_cast<float>(decode(static_cast<double>(i) / 255.0));
+        }
+        return values;
+      }();
+
+      return table;
+    }
+
+    /**
+     * Linear values halfway between each pair of adjacent sRGB codes (in sRGB space), so the number of thresholds
+     * below a value is the nearest code.
+     */
+    const std::array<float, 255>& getEncodeThresholds() {
+      static const auto table = [] {
+        std::array<float, 255> values{};
+        for (size_t i = 0; i < values.size(); i++) {
+          values[i] = static_cast<float>(decode((static_cast<double>(i) + 0.5) / 255.0));
+        }
+        return values;
+      }();
+
+      return table;
+    }
+  }
+
+  float srgbToLinear(const uint8_t value) {
+    return getLinearTable()[value];
+  }
+
+  uint8_t linearToSrgb(const float value) {
+    // Written so NaN falls through to 0
+    if (!(value > 0.0f)) {
+      return 0;
+    }
+
+    const auto& thresholds = getEncodeThresholds();
+    return static_cast<uint8_t>(std::ranges::upper_bound(thresholds, value) - thresholds.begin());
+  }
+}
@@ -0,0 +1,15 @@
+#pragma once
+
+#include <cstdint>
+
+namespace VtfParser::Internal {
+  /**
+   * Converts an sRGB encoded 8-bit value to linear light in [0, 1].
+   */
+  [[nodiscard]] float srgbToLinear(uint8_t value);
+
+  /**
+   * Converts a linear light value to the nearest sRGB encoded 8-bit value, clamping to [0, 1] first.
+   */
+  [[nodiscard]] uint8_t linearToSrgb(float value);
+}
@@ -0,0 +1,422 @@
+#include "mip-chain.hpp"
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cmath>
+#include <cstring>
+#include <numbers>
+#include <source-parsers-shared/errors.hpp>
+#include <source-parsers-shared/internal/half-float.hpp>
+#include <source-parsers-shared/internal/parallel-for.hpp>
+#include "helpers/image-sizes.hpp"
+#include "helpers/simd.hpp"
+#include "helpers/srgb.hpp"
+
+namespace VtfParser {
+  using namespace SourceParsers::Errors;
+  using namespace SourceParsers::Internal;
+  using namespace VtfParser::Internal;
+
+  namespace {
+    constexpr size_t CHANNELS = 4;
+    constexpr float INV_255 = 1.0f / 255.0f;
+
+    /**
+     * Output rows filtered by each job.
+     */
+    constexpr uint32_t FILTER_BAND_ROWS = 64;
+
+    /**
+     * Half width of the Kaiser filter, in output pixels.
+     */
+    constexpr double KAISER_RADIUS = 3.0;
+    constexpr double KAISER_BETA = 4.0;
+
+    struct Tap {
+      uint32_t index;
+      float weight;
+    };
+
+    /**
+     * Source pixels and weights contributing to each output pixel along one axis. Taps of each output pixel are in
+     * ascending source order.
+     */
+    class AxisFilter {
+    public:
+      [[nodiscard]] std::span<const Tap> getTaps(const size_t outputIndex) const {
+        return std::span(taps).subspan(offsets[outputIndex], offsets[outputIndex + 1] - offsets[outputIndex]);
+      }
+
+      void addTap(const uint32_t index, const float weight) {
+        // Clamping at the edges maps several taps onto the same source pixel, so merge them
+        if (taps.size() > offsets.back() && taps.back().index == index) {
+          taps.back().weight += weight;
+        } else {
+          taps.push_back({ index, weight });
+        }
+      }
+
+      void finishOutput() {
+        float sum = 0;
+        for (size_t i = offsets.back(); i < taps.size(); i++) {
+          sum += taps[i].weight;
+        }
+        for (size_t i = offsets.back(); i < taps.size(); i++) {
+          taps[i].weight /= sum;
+        }
+
+        offsets.push_back(taps.size());
+      }
+
+    private:
+      std::vector<Tap> taps;
+      std::vector<size_t> offsets = { 0 };
+    };
+
+    /**
+     * Zeroth order modified Bessel function of the first kind, from its power series.
+     */
+    double besselI0(const double x) {
+      double sum = 1;
+      double term = 1;
+      for (int k = 1; k < 32; k++) {
+        term *= (x / (2 * k)) * (x / (2 * k));
+        sum += term;
+        if (term < sum * 1e-12) {
+          break;
+        }
+      }
+
+      return sum;
+    }
+
+    double kaiserSinc(const double x) {
+      const auto ratio = x / KAISER_RADIUS;
+      const auto window = besselI0(KAISER_BETA * std::sqrt(1 - ratio * ratio)) / besselI0(KAISER_BETA);
+      const auto sinc = x == 0 ? 1.0 : std::sin(std::numbers::pi * x) / (std::numbers::pi * x);
+
+      return sinc * window;
+    }
+
+    AxisFilter buildAxisFilter(const uint32_t sourceSize, const uint32_t outputSize, const MipFilter filter) {
+      AxisFilter axis;
+      const auto scale = static_cast<double>(sourceSize) / outputSize;
+
+      for (uint32_t i = 0; i < outputSize; i++) {
+        if (sourceSize == outputSize) {
+          axis.addTap(i, 1);
+        } else if (filter == MipFilter::Box) {
+          // Weight each source pixel by how much of it the output pixel covers, which also handles odd extents
+          const auto start = i * scale;
+          const auto end = (i + 1) * scale;
+          for (auto source = static_cast<uint32_t>(start); source < end; source++) {
+            const auto coverage = std::min<double>(end, source + 1) - std::max<double>(start, source);
+            if (coverage > 0) {
+              axis.addTap(source, static_cast<float>(coverage));
+            }
+          }
+        } else {
+          const auto centre = (i + 0.5) * scale;
+          const auto first = static_cast<int64_t>(std::floor(centre - KAISER_RADIUS * scale));
+          const auto last = static_cast<int64_t>(std::ceil(centre + KAISER_RADIUS * scale));
+          for (auto source = first; source <= last; source++) {
+            const auto distance = (source + 0.5 - centre) / scale;
+            if (std::abs(distance) >= KAISER_RADIUS) {
+              continue;
+            }
+
+            const auto clamped = static_cast<uint32_t>(std::clamp<int64_t>(source, 0, sourceSize - 1));
+            axis.addTap(clamped, static_cast<float>(kaiserSinc(distance)));
+          }
+        }
+
+        axis.finishOutput();
+      }
+
+      return axis;
+    }
+
+    /**
+     * Loads a row of pixels as linear RGBA32F.
+     */
+    void loadRow(
+      const ImageFormat format,
+      const bool srgb,
+      const std::byte* source,
+      const uint32_t width,
+      float* output
+    ) {
+      if (format == ImageFormat::RGBA16161616F) {
+        for (size_t i = 0; i < width * CHANNELS; i++) {
+          uint16_t half;
+          std::memcpy(&half, source + i * sizeof(uint16_t), sizeof(uint16_t));
+          output[i] = halfToFloat(half);
+        }
+        return;
+      }
+
+      for (size_t i = 0; i < width * CHANNELS; i += CHANNELS) {
+        for (size_t c = 0; c < CHANNELS; c++) {
+          const auto value = static_cast<uint8_t>(source[i + c]);
+          output[i + c] = srgb && c < 3 ? srgbToLinear(value) : static_cast<float>(value) * INV_255;
+        }
+      }
+    }
+
+    /**
+     * Stores a row of linear RGBA32F pixels in the output format.
+     */
+    void storeRow(const ImageFormat format, const bool srgb, const float* source, const uint32_t width, std::byte* output) {
+      if (format == ImageFormat::RGBA16161616F) {
+        for (size_t i = 0; i < width * CHANNELS; i++) {
+          const auto half = floatToHalf(source[i]);
+          std::memcpy(output + i * sizeof(uint16_t), &half, sizeof(uint16_t));
+        }
+        return;
+      }
+
+      for (size_t i = 0; i < width * CHANNELS; i += CHANNELS) {
+        for (size_t c = 0; c < CHANNELS; c++) {
+          const auto value = source[i + c];
+          if (srgb && c < 3) {
+            output[i + c] = static_cast<std::byte>(linearToSrgb(value));
+          } else {
+            // Written so NaN falls through to 0
+            const auto clamped = value > 0.0f ? std::min(value, 1.0f) : 0.0f;
+            output[i + c] = static_cast<std::byte>(clamped * 255.0f + 0.5f);
+          }
+        }
+      }
+    }
+
+    /**
+     * Filters a row of RGBA32F pixels horizontally.
+     */
+    void filterRow(const float* source, const AxisFilter& filter, const uint32_t outputWidth, float* output) {
+      for (size_t x = 0; x < outputWidth; x++) {
+#if VTFPARSER_SSE2
+        auto sum = _mm_setzero_ps();
+        for (const auto& tap : filter.getTaps(x)) {
+          sum = _mm_add_ps(sum, _mm_mul_ps(_mm_loadu_ps(source + tap.index * CHANNELS), _mm_set1_ps(tap.weight)));
+        }
+        _mm_storeu_ps(output + x * CHANNELS, sum);
+#else
+        std::array<float, CHANNELS> sum{};
+        for (const auto& tap : filter.getTaps(x)) {
+          for (size_t c = 0; c < CHANNELS; c++) {
+            sum[c] += source[tap.index * CHANNELS + c] * tap.weight;
+          }
+        }
+        std::memcpy(output + x * CHANNELS, sum.data(), sizeof(sum));
+#endif
+      }
+    }
+
+    /**
+     * Adds a weighted row of floats to an accumulator, for the vertical and depth filter passes.
+     */
+    void accumulateRow(float* accumulator, const float* source, const float weight, const size_t count) {
+      size_t i = 0;
+#if VTFPARSER_SSE2
+      const auto weights = _mm_set1_ps(weight);
+      for (; i + 4 <= count; i += 4) {
+        const auto sum = _mm_add_ps(_mm_loadu_ps(accumulator + i), _mm_mul_ps(_mm_loadu_ps(source + i), weights));
+        _mm_storeu_ps(accumulator + i, sum);
+      }
+#endif
+      for (; i < count; i++) {
+        accumulator[i] += source[i] * weight;
+      }
+    }
+
+    struct Extent {
+      uint32_t width;
+      uint32_t height;
+      uint32_t depth;
+    };
+
+    /**
+     * One level of the chain being filtered from the level above it.
+     */
+    struct LevelFilter {
+      ImageFormat format;
+      bool srgb;
+      Extent sourceExtent;
+      Extent extent;
+      AxisFilter x;
+      AxisFilter y;
+      AxisFilter z;
+      size_t pixelSize;
+    };
+
+    /**
+     * Filters a band of rows of one output slice.
+     * @param source First slice of the source level for this frame and face.
+     * @param output First slice of the output level for this frame and face.
+     */
+    void filterBand(
+      const LevelFilter& level,
+      const std::byte* source,
+      std::byte* output,
+      const uint32_t outputZ,
+      const uint32_t firstRow,
+      const uint32_t rowCount
+    ) {
+      const auto& [sourceWidth, sourceHeight, sourceDepth] = level.sourceExtent;
+      const auto& [width, height, depth] = level.extent;
+      const auto sourceRowSize = sourceWidth * level.pixelSize;
+      const auto sourceSliceSize = sourceRowSize * sourceHeight;
+      const auto rowFloats = static_cast<size_t>(width) * CHANNELS;
+
+      // Filter every source row the band needs horizontally first, once per depth tap
+      const auto depthTaps = level.z.getTaps(outputZ);
+      const auto sourceFirstRow = level.y.getTaps(firstRow).front().index;
+      const auto sourceRowCount = level.y.getTaps(firstRow + rowCount - 1).back().index - sourceFirstRow + 1;
+
+      std::vector<float> sourceRow(static_cast<size_t>(sourceWidth) * CHANNELS);
+      std::vector<float> filteredRows(depthTaps.size() * sourceRowCount * rowFloats);
+      for (size_t depthTap = 0; depthTap < depthTaps.size(); depthTap++) {
+        for (uint32_t row = 0; row < sourceRowCount; row++) {
+          const auto* sourceData = source + depthTaps[depthTap].index * sourceSliceSize +
+            (sourceFirstRow + row) * sourceRowSize;
+          loadRow(level.format, level.srgb, sourceData, sourceWidth, sourceRow.data());
+          filterRow(
+            sourceRow.data(),
+            level.x,
+            width,
+            &filteredRows[(depthTap * sourceRowCount + row) * rowFloats]
+          );
+        }
+      }
+
+      std::vector<float> outputRow(rowFloats);
+      const auto sliceSize = static_cast<size_t>(width) * height * level.pixelSize;
+      for (auto y = firstRow; y < firstRow + rowCount; y++) {
+        std::ranges::fill(outputRow, 0.0f);
+
+        for (size_t depthTap = 0; depthTap < depthTaps.size(); depthTap++) {
+          for (const auto& tap : level.y.getTaps(y)) {
+            accumulateRow(
+              outputRow.data(),
+              &filteredRows[(depthTap * sourceRowCount + tap.index - sourceFirstRow) * rowFloats],
+              depthTaps[depthTap].weight * tap.weight,
+              rowFloats
+            );
+          }
+        }
+
+        storeRow(
+          level.format,
+          level.srgb,
+          outputRow.data(),
+          width,
+          output + outputZ * sliceSize + static_cast<size_t>(y) * width * level.pixelSize
+        );
+      }
+    }
+
+    ImageSizeInfo getSourceSizeInfo(const MipChainSource& source, const MipChainOptions& options) {
+      if (source.format != ImageFormat::RGBA8888 && source.format != ImageFormat::RGBA16161616F) {
+        throw UnsupportedFormat("Mip chains can only be generated for RGBA8888 or RGBA16161616F");
+      }
+
+      if (source.width == 0 || source.height == 0 || source.depth == 0 || source.frames == 0 || source.faces == 0) {
+        throw OutOfBoundsAccess("Image to generate mip levels for has no pixels");
+      }
+
+      const auto fullMipLevels = getFullMipLevels(source.width, source.height, source.depth);
+      if (options.mipLevels > fullMipLevels) {
+        throw OutOfBoundsAccess("More mip levels were requested than the image has");
+      }
+
+      return {
+        .format = source.format,
+        .width = source.width,
+        .height = source.height,
+        .depth = source.depth,
+        .faces = source.faces,
+        .frames = source.frames,
+        .mipLevels = options.mipLevels == 0 ? fullMipLevels : options.mipLevels,
+      };
+    }
+  }
+
+  uint8_t getFullMipLevels(const uint16_t width, const uint16_t height, const uint16_t depth) {
+    return static_cast<uint8_t>(std::bit_width(std::max({ width, height, depth, uint16_t{ 1 } })));
+  }
+
+  size_t getMipChainSizeBytes(const MipChainSource& source, const MipChainOptions& options) {
+    return getImageSizeBytes(getSourceSizeInfo(source, options));
+  }
+
+  void generateMipChain(const MipChainSource& source, const std::span<std::byte> output, const MipChainOptions& options) {
+    const auto sizeInfo = getSourceSizeInfo(source, options);
+
+    const auto levelSize = getMipSizeBytes(getMipSizeInfo(sizeInfo, 0));
+    if (source.data.size() < levelSize) {
+      throw OutOfBoundsAccess("Image data is too short for the given extent");
+    }
+    if (output.size() < getImageSizeBytes(sizeInfo)) {
+      throw OutOfBoundsAccess("Output buffer is too small for the mip chain");
+    }
+
+    std::memcpy(output.data() + getMipOffsetBytes(sizeInfo, 0), source.data.data(), levelSize);
+
+    const auto slices = static_cast<size_t>(source.frames) * source.faces;
+    for (uint8_t mipLevel = 1; mipLevel < sizeInfo.mipLevels; mipLevel++) {
+      const auto sourceSizeInfo = getMipSizeInfo(sizeInfo, mipLevel - 1);
+      const auto mipSizeInfo = getMipSizeInfo(sizeInfo, mipLevel);
+      const Extent sourceExtent = {
+        static_cast<uint32_t>(sourceSizeInfo.width),
+        static_cast<uint32_t>(sourceSizeInfo.height),
+        static_cast<uint32_t>(sourceSizeInfo.depth),
+      };
+      const Extent extent = {
+        static_cast<uint32_t>(mipSizeInfo.width),
+        static_cast<uint32_t>(mipSizeInfo.height),
+        static_cast<uint32_t>(mipSizeInfo.depth),
+      };
+
+      const LevelFilter level = {
+        .format = source.format,
+        .srgb = options.srgb && source.format == ImageFormat::RGBA8888,
+        .sourceExtent = sourceExtent,
+        .extent = extent,
+        .x = buildAxisFilter(sourceExtent.width, extent.width, options.filter),
+        .y = buildAxisFilter(sourceExtent.height, extent.height, options.filter),
+        .z = buildAxisFilter(sourceExtent.depth, extent.depth, options.filter),
+        .pixelSize = getPixelSizeBytes(source.format),
+      };
+
+      const auto* sourceLevel = output.data() + getMipOffsetBytes(sizeInfo, mipLevel - 1);
+      auto* outputLevel = output.data() + getMipOffsetBytes(sizeInfo, mipLevel);
+      const auto sourceFaceSize = getFaceSizeBytes(sourceSizeInfo);
+      const auto faceSize = getFaceSizeBytes(mipSizeInfo);
+
+      // Each level reads the one above it, so levels run one after another with their bands spread across workers
+      const auto bands = (extent.height + FILTER_BAND_ROWS - 1) / FILTER_BAND_ROWS;
+      const auto jobsPerSlice = static_cast<size_t>(extent.depth) * bands;
+      parallelFor(slices * jobsPerSlice, options.threadCount, [&](const size_t job) {
+        const auto slice = job / jobsPerSlice;
+        const auto z = static_cast<uint32_t>(job % jobsPerSlice / bands);
+        const auto firstRow = static_cast<uint32_t>(job % bands) * FILTER_BAND_ROWS;
+
+        filterBand(
+          level,
+          sourceLevel + slice * sourceFaceSize,
+          outputLevel + slice * faceSize,
+          z,
+          firstRow,
+          std::min(FILTER_BAND_ROWS, extent.height - firstRow)
+        );
+      });
+    }
+  }
+
+  std::vector<std::byte> generateMipChain(const MipChainSource& source, const MipChainOptions& options) {
+    std::vector<std::byte> output(getMipChainSizeBytes(source, options));
+    generateMipChain(source, output, options);
+
+    return output;
+  }
+}
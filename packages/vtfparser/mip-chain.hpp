@@ -0,0 +1,115 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+#include "file-format-objects/enums.hpp"
+
+namespace VtfParser {
+  /**
+   * Filter used to downsample each mip level from the one above it.
+   */
+  enum class MipFilter : uint8_t {
+    /**
+     * Area average of the source pixels covered by each output pixel. Fast, but slightly blurry.
+     */
+    Box,
+    /**
+     * Kaiser windowed sinc, 3 output pixels wide. Keeps noticeably more detail than Box, at the cost of some ringing
+     * around hard edges.
+     */
+    Kaiser
+  };
+
+  /**
+   * Options controlling how a mip chain is generated.
+   */
+  struct MipChainOptions {
+    MipFilter filter = MipFilter::Box;
+    /**
+     * Whether the RGB channels of RGBA8888 sources are sRGB encoded, so are filtered in linear light. Set this to
+     * false for normal maps and other non-colour data. Alpha is always filtered as is, as are RGBA16161616F sources.
+     */
+    bool srgb = true;
+    /**
+     * Number of mip levels to produce, including the source level. 0 produces a full chain down to 1x1x1.
+     */
+    uint8_t mipLevels = 0;
+    /**
+     * Number of threads to filter with. 0 uses the number of hardware threads.
+     */
+    unsigned int threadCount = 0;
+  };
+
+  /**
+   * Level 0 of an image to generate mip levels for.
+   */
+  struct MipChainSource {
+    /**
+     * Pixels of each slice one after another, in the same order as Vtf::getImageSliceOffset() (frame, then face,
+     * then depth).
+     */
+    std::span<const std::byte> data;
+    /**
+     * Pixel format of the data and the output. Either RGBA8888 or RGBA16161616F.
+     */
+    ImageFormat format = ImageFormat::RGBA8888;
+    uint16_t width;
+    uint16_t height;
+    uint16_t depth = 1;
+    uint16_t frames = 1;
+    uint8_t faces = 1;
+  };
+
+  /**
+   * Gets the number of mip levels in a full chain down to 1x1x1.
+   * @param width Width of level 0 in pixels.
+   * @param height Height of level 0 in pixels.
+   * @param depth Depth of level 0 in pixels.
+   * @return Number of mip levels, including level 0.
+   */
+  [[nodiscard]] uint8_t getFullMipLevels(uint16_t width, uint16_t height, uint16_t depth = 1);
+
+  /**
+   * Gets the number of bytes generateMipChain writes.
+   * @param source Level 0 of the image.
+   * @param options Generation options.
+   * @return Size of the mip chain in bytes.
+   * @throws Errors::UnsupportedFormat The source format is not RGBA8888 or RGBA16161616F.
+   * @throws Errors::OutOfBoundsAccess The source has no pixels, or more mip levels are requested than the image has.
+   */
+  [[nodiscard]] size_t getMipChainSizeBytes(const MipChainSource& source, const MipChainOptions& options = {});
+
+  /**
+   * Generates every mip level of the source, each filtered from the level above it.
+   * @remark The output is laid out like VTF high resolution image data: smallest mip level first, then frame, face
+   * @remark and depth. It can be indexed with the same offsets as Vtf::getImageSliceOffset(), uploaded directly, or
+   * @remark compressed level by level.
+   * @param source Level 0 of the image, which is copied unchanged into the output.
+   * @param output Destination buffer, which must be at least getMipChainSizeBytes bytes long.
+   * @param options Generation options.
+   * @throws Errors::UnsupportedFormat The source format is not RGBA8888 or RGBA16161616F.
+   * @throws Errors::OutOfBoundsAccess The source has no pixels, more mip levels are requested than the image has, the
+   * source data is too short for its extent, or the output is too small.
+   */
+  void generateMipChain(
+    const MipChainSource& source,
+    std::span<std::byte> output,
+    const MipChainOptions& options = {}
+  );
+
+  /**
+   * Generates every mip level of the source into a new buffer.
+   * @param source Level 0 of the image, which is copied unchanged into the output.
+   * @param options Generation options.
+   * @return Mip chain, laid out as described by the overload taking an output buffer.
+   * @throws Errors::UnsupportedFormat The source format is not RGBA8888 or RGBA16161616F.
+   * @throws Errors::OutOfBoundsAccess The source has no pixels, more mip levels are requested than the image has, or
+   * the source data is too short for its extent.
+   */
+  [[nodiscard]] std::vector<std::byte> generateMipChain(
+    const MipChainSource& source,
+    const MipChainOptions& options = {}
+  );
+}
@@ -0,0 +1,87 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace VtfParser {
+  /**
+   * Region of the texture used by one image of a sheet frame, in normalised texture coordinates.
+   */
+  struct SheetImageRect {
+    float uMin;
+    float vMin;
+    float uMax;
+    float vMax;
+  };
+
+  /**
+   * Single frame of a sheet sequence.
+   */
+  struct SheetFrame {
+    /**
+     * How long the frame is shown for, in seconds.
+     */
+    float duration;
+    /**
+     * Images blended together for this frame. Only the first Sheet::imagesPerFrame are used.
+     */
+    std::array<SheetImageRect, 4> images;
+  };
+
+  /**
+   * Animation sequence within a sheet, referring to a contiguous run of Sheet::frames.
+   */
+  struct SheetSequence {
+    /**
+     * Sequence number used by materials and particle systems to select this sequence.
+     */
+    uint32_t sequenceNumber;
+    /**
+     * Whether the sequence stops on its last frame, rather than looping.
+     */
+    bool clamp;
+    /**
+     * Total length of the sequence, in seconds.
+     */
+    float totalTime;
+    /**
+     * Index of the sequence's first frame in Sheet::frames.
+     */
+    size_t firstFrame;
+    /**
+     * Number of frames in the sequence.
+     */
+    size_t frameCount;
+  };
+
+  /**
+   * Decoded sheet resource, describing how an animated sprite's texture is split into frames.
+   */
+  struct Sheet {
+    /**
+     * Sheet format version (0 or 1).
+     */
+    uint32_t version;
+    /**
+     * Number of images per frame: 1 for version 0 and 4 for version 1, which supports multi-image blending.
+     */
+    uint8_t imagesPerFrame;
+    std::vector<SheetSequence> sequences;
+    /**
+     * Frames of every sequence, stored back to back in sequence order.
+     */
+    std::vector<SheetFrame> frames;
+
+    /**
+     * Gets the frames belonging to a sequence.
+     * @param sequence One of the sheet's sequences.
+     * @return View over the sequence's frames.
+     */
+    [[nodiscard]] std::span<const SheetFrame> getFrames(const SheetSequence& sequence) const {
+      return std::span(frames).subspan(sequence.firstFrame, sequence.frameCount);
+    }
+  };
+}
@@ -1,12 +1,16 @@
 #include "vtf.hpp"
+#include <algorithm>
 #include <cstring>
 #include <utility>
 #include <source-parsers-shared/internal/check-bounds.hpp>
 #include <source-parsers-shared/errors.hpp>
+#include "helpers/image-sizes.hpp"
+#include "helpers/sheet-parser.hpp"
 
 namespace VtfParser {
   using namespace SourceParsers::Errors;
   using namespace SourceParsers::Internal;
+  using namespace VtfParser::Internal;
 
   namespace {
     constexpr std::array<char, 4> FILE_ID = { 'V', 'T', 'F', 0 };
@@ -20,141 +24,109 @@ namespace VtfParser {
      */
     constexpr uint32_t MIN_RESOURCE_INFO_MINOR_VERSION = 3;
 
-    constexpr std::array<uint8_t, 3> LOW_RES_RESOURCE_TAG = { 0x01, 0, 0 };
-    constexpr std::array<uint8_t, 3> HIGH_RES_RESOURCE_TAG = { 0x30, 0, 0 };
-
-    struct ImageSizeInfo {
-      ImageFormat format;
-      size_t width;
-      size_t height;
-      size_t depth;
-      size_t faces;
-      size_t frames;
-      uint8_t mipLevels;
-    };
+    /**
+     * Size of the header fields present in every version, up to and including the low res image extent.
+     */
+    constexpr size_t MIN_HEADER_SIZE = 63;
 
     /**
-     * Returns the number of bytes used by each pixel of the given format.
-     * @remark Only works with uncompressed formats.
-     * @param format
-     * @return Size of each pixel in bytes.
+     * Offset of the resource table in 7.3+ headers.
      */
-    size_t getPixelSizeBytes(const ImageFormat format) {
-      switch (format) {
-        case ImageFormat::RGBA16161616F:
-        case ImageFormat::RGBA16161616:
-          return 8;
-        case ImageFormat::RGBA8888:
-        case ImageFormat::ABGR8888:
-        case ImageFormat::ARGB8888:
-        case ImageFormat::BGRA8888:
-        case ImageFormat::BGRX8888:
-        case ImageFormat::UVWQ8888:
-        case ImageFormat::UVLX8888:
-          return 4;
-        case ImageFormat::RGB888:
-        case ImageFormat::BGR888:
-        case ImageFormat::RGB888_BLUESCREEN:
-        case ImageFormat::BGR888_BLUESCREEN:
-          return 3;
-        case ImageFormat::RGB565:
-        case ImageFormat::IA88:
-        case ImageFormat::BGR565:
-        case ImageFormat::BGRX5551:
-        case ImageFormat::BGRA4444:
-        case ImageFormat::BGRA5551:
-        case ImageFormat::UV88:
-          return 2;
-        case ImageFormat::I8:
-        case ImageFormat::P8:
-        case ImageFormat::A8:
-          return 1;
-        default:
-          throw InvalidHeader("Unrecognised image format");
+    constexpr size_t RESOURCE_TABLE_OFFSET = sizeof(Header) - Header::MAX_RESOURCES * sizeof(ResourceEntryInfo);
+    static_assert(RESOURCE_TABLE_OFFSET == 80);
+
+    std::span<const std::byte> getDataRange(
+      const std::span<const std::byte> data,
+      const size_t offset,
+      const size_t size,
+      const char* errorMessage
+    ) {
+      if (offset > data.size() || size > data.size() - offset) {
+        throw OutOfBoundsAccess(errorMessage);
       }
-    }
-
-    size_t getSliceSizeBytes(const ImageSizeInfo& sizeInfo) {
-      switch (sizeInfo.format) {
-        case ImageFormat::DXT1:
-        case ImageFormat::DXT1_ONEBITALPHA: {
-          const auto width = std::max<size_t>(sizeInfo.width, 4);
-          const auto height = std::max<size_t>(sizeInfo.height, 4);
 
-          return ((width + 3u) >> 2u) * ((height + 3u) >> 2u) * 8u;
-        }
-        case ImageFormat::DXT3:
-        case ImageFormat::DXT5: {
-          const auto width = std::max<size_t>(sizeInfo.width, 4);
-          const auto height = std::max<size_t>(sizeInfo.height, 4);
+      return data.subspan(offset, size);
+    }
 
-          return ((width + 3u) >> 2u) * ((height + 3u) >> 2u) * 16u;
-        }
-        default:
-          return sizeInfo.width * sizeInfo.height * getPixelSizeBytes(sizeInfo.format);
+    /**
+     * Checks the fields shared by every version, and fixes up those which older versions don't have.
+     */
+    void validateHeader(HeaderFullAligned& header) {
+      if (memcmp(header.signature.data(), FILE_ID.data(), 4) != 0) {
+        throw InvalidHeader("VTF header has an invalid file ID");
       }
-    }
 
-    size_t getFaceSizeBytes(const ImageSizeInfo& sizeInfo) {
-      return getSliceSizeBytes(sizeInfo) * sizeInfo.depth;
-    }
+      if (header.version[0] != SUPPORTED_MAJOR_VERSION || header.version[1] < MIN_SUPPORTED_MINOR_VERSION || header.
+        version[1] > MAX_SUPPORTED_MINOR_VERSION) {
+        throw UnsupportedVersion("VTF version is not supported");
+      }
 
-    size_t getFrameSizeBytes(const ImageSizeInfo& sizeInfo) {
-      return getFaceSizeBytes(sizeInfo) * sizeInfo.faces;
-    }
+      // Fix-up for old versions of the format, which put garbage data here
+      if (header.version[1] < 2) {
+        header.depth = 1;
+      }
+      if (header.version[1] < MIN_RESOURCE_INFO_MINOR_VERSION) {
+        header.numResources = 0;
+      }
 
-    size_t getMipSizeBytes(const ImageSizeInfo& sizeInfo) {
-      return getFrameSizeBytes(sizeInfo) * sizeInfo.frames;
-    }
+      if (header.highResImageFormat == ImageFormat::NONE) {
+        throw InvalidHeader("VTF high res image format is NONE");
+      }
 
-    size_t getImageSizeBytes(const ImageSizeInfo& sizeInfo) {
-      if (sizeInfo.format == ImageFormat::NONE) {
-        return 0;
+      if (header.numResources > Header::MAX_RESOURCES) {
+        throw InvalidHeader("VTF resource count is higher than maximum allowed");
       }
+    }
 
-      size_t size = 0;
-      for (uint8_t mipLevel = 0; mipLevel < sizeInfo.mipLevels; mipLevel++) {
-        auto mipSizeInfo = sizeInfo;
-        mipSizeInfo.width = std::max<size_t>(sizeInfo.width >> mipLevel, 1ul);
-        mipSizeInfo.height = std::max<size_t>(sizeInfo.height >> mipLevel, 1ul);
-        mipSizeInfo.depth = std::max<size_t>(sizeInfo.depth >> mipLevel, 1ul);
-        size += getMipSizeBytes(mipSizeInfo);
+    uint8_t getFaceCount(const HeaderFullAligned& header) {
+      if ((header.flags & TextureFlags::ENVMAP) == TextureFlags::NONE) {
+        return 1;
       }
 
-      return size;
+      return header.firstFrame == 0xffff && header.version[1] < 5 ? 7 : 6;
     }
   }
 
-  Vtf::Vtf(const std::span<const std::byte> data) {
-    checkBounds(0, sizeof(Header), data.size(), "Failed to parse VTF header");
-    header = *reinterpret_cast<const Header*>(data.data());
+  Vtf::HeaderSummary Vtf::probe(const std::span<const std::byte> data) {
+    checkBounds(0, MIN_HEADER_SIZE, data.size(), "Failed to parse VTF header");
 
-    if (memcmp(header.signature.data(), FILE_ID.data(), 4) != 0) {
-      throw InvalidHeader("VTF header has an invalid file ID");
-    }
-
-    if (header.version[0] != SUPPORTED_MAJOR_VERSION || header.version[1] < MIN_SUPPORTED_MINOR_VERSION || header.
-      version[1] > MAX_SUPPORTED_MINOR_VERSION) {
-      throw UnsupportedVersion("VTF version is not supported");
-    }
+    HeaderFullAligned header{};
+    std::memcpy(&header, data.data(), std::min(sizeof(HeaderFullAligned), data.size()));
+    validateHeader(header);
 
-    // Fix-up for old versions of the format, which put garbage data here
-    if (header.version[1] < 2) {
-      header.depth = 1;
-    }
-    if (header.version[1] < MIN_RESOURCE_INFO_MINOR_VERSION) {
-      header.numResources = 0;
-    }
+    // Copied out first, as std::max would bind a reference to the packed (and possibly misaligned) field
+    const uint16_t depth = header.depth;
 
-    if (header.highResImageFormat == ImageFormat::NONE) {
-      throw InvalidHeader("VTF high res image format is NONE");
-    }
+    return {
+      .version = header.version,
+      .format = header.highResImageFormat,
+      .extent = { header.width, header.height, std::max<uint16_t>(depth, 1) },
+      .mipLevels = header.mipmapCount,
+      .frames = header.frames,
+      .faces = getFaceCount(header),
+      .flags = header.flags,
+      .lowResImageFormat = header.lowResImageFormat,
+      .lowResImageExtent = { header.lowResImageWidth, header.lowResImageHeight },
+    };
+  }
 
-    if (header.numResources > Header::MAX_RESOURCES) {
-      throw InvalidHeader("VTF resource count is higher than maximum allowed");
+  Vtf::Vtf(const std::span<const std::byte> data, const LoadMode loadMode) {
+    // Older versions have shorter headers, so only what's present is copied and the rest stays zeroed
+    checkBounds(0, MIN_HEADER_SIZE, data.size(), "Failed to parse VTF header");
+    std::memcpy(&header, data.data(), std::min(sizeof(Header), data.size()));
+    validateHeader(header);
+
+    if (header.numResources > 0) {
+      checkBounds(
+        0,
+        RESOURCE_TABLE_OFFSET + header.numResources * sizeof(ResourceEntryInfo),
+        data.size(),
+        "Failed to parse VTF resource table"
+      );
     }
 
-    const auto lowResImageDataSize = getImageSizeBytes(
+    // Textures without a thumbnail have no low res image at all
+    const auto lowResImageDataSize = header.lowResImageFormat == ImageFormat::NONE ? 0 : getImageSizeBytes(
       ImageSizeInfo{
         .format = header.lowResImageFormat,
         .width = header.lowResImageWidth,
@@ -165,29 +137,101 @@ namespace VtfParser {
         .mipLevels = 1,
       }
     );
-    const auto highResImageDataSize = getImageSizeBytes(
-      {
+
+    // Smallest mips are stored first, so walk the chain backwards accumulating offsets
+    mipLayouts.resize(header.mipmapCount);
+    size_t highResImageDataSize = 0;
+    for (auto mipLevel = static_cast<int>(header.mipmapCount) - 1; mipLevel >= 0; mipLevel--) {
+      const auto extent = getHighResImageExtent(static_cast<uint8_t>(mipLevel));
+      const ImageSizeInfo mipSize = {
         .format = header.highResImageFormat,
-        .width = header.width,
-        .height = header.height,
-        .depth = header.depth,
+        .width = extent.width,
+        .height = extent.height,
+        .depth = extent.depth,
         .faces = getFaces(),
         .frames = header.frames,
         .mipLevels = header.mipmapCount,
-      }
-    );
+      };
+
+      mipLayouts[mipLevel] = {
+        .offset = highResImageDataSize,
+        .frameSizeBytes = getFrameSizeBytes(mipSize),
+        .faceSizeBytes = getFaceSizeBytes(mipSize),
+        .sliceSizeBytes = getSliceSizeBytes(mipSize),
+        .sizeBytes = getMipSizeBytes(mipSize),
+      };
+      highResImageDataSize += mipLayouts[mipLevel].sizeBytes;
+    }
+
+    lowResImageRange.size = lowResImageDataSize;
+    highResImageRange.size = highResImageDataSize;
 
     if (header.version[1] >= MIN_RESOURCE_INFO_MINOR_VERSION) {
+      resources.reserve(header.numResources);
+      auto hasLowResImage = false;
+
       for (const auto& resourceInfo : std::span(header.resourceInfos).subspan(0, header.numResources)) {
-        if (resourceInfo.tag == LOW_RES_RESOURCE_TAG) {
-          lowResImageData = data.subspan(resourceInfo.data, lowResImageDataSize);
-        } else if (resourceInfo.tag == HIGH_RES_RESOURCE_TAG) {
-          highResImageData = data.subspan(resourceInfo.data, highResImageDataSize);
+        if (resourceInfo.tag == ResourceTags::LOW_RES_IMAGE) {
+          lowResImageRange.offset = resourceInfo.data;
+          hasLowResImage = true;
+        } else if (resourceInfo.tag == ResourceTags::HIGH_RES_IMAGE) {
+          highResImageRange.offset = resourceInfo.data;
         }
+
+        resources.push_back(
+          {
+            .tag = resourceInfo.tag,
+            .flags = resourceInfo.flags,
+            .value = resourceInfo.data,
+            .data = {},
+          }
+        );
+      }
+
+      // Without a resource the format in the header is meaningless, and there is no low res image
+      if (!hasLowResImage) {
+        lowResImageRange.size = 0;
       }
     } else {
-      lowResImageData = data.subspan(header.headerSize, lowResImageDataSize);
-      highResImageData = data.subspan(header.headerSize + lowResImageDataSize, highResImageDataSize);
+      lowResImageRange.offset = header.headerSize;
+      highResImageRange.offset = header.headerSize + lowResImageDataSize;
+    }
+
+    if (loadMode == LoadMode::HeaderOnly) {
+      return;
+    }
+
+    lowResImageData = getDataRange(
+      data,
+      lowResImageRange.offset,
+      lowResImageRange.size,
+      "VTF low res image data is out of bounds"
+    );
+    highResImageData = getDataRange(
+      data,
+      highResImageRange.offset,
+      highResImageRange.size,
+      "VTF high res image data is out of bounds"
+    );
+
+    for (auto& resource : resources) {
+      if (resource.tag == ResourceTags::LOW_RES_IMAGE) {
+        resource.data = lowResImageData;
+      } else if (resource.tag == ResourceTags::HIGH_RES_IMAGE) {
+        resource.data = highResImageData;
+      } else if ((resource.flags & RESOURCE_FLAG_NO_DATA_CHUNK) == 0) {
+        // Other data chunks are prefixed with their size
+        const auto sizePrefix = getDataRange(data, resource.value, sizeof(uint32_t), "VTF resource is out of bounds");
+        uint32_t size;
+        std::memcpy(&size, sizePrefix.data(), sizeof(size));
+
+        resource.data = getDataRange(
+          data,
+          static_cast<size_t>(resource.value) + sizeof(uint32_t),
+          size,
+          "VTF resource data is out of bounds"
+        );
+      }
     }
   }
 
@@ -204,11 +248,7 @@ namespace VtfParser {
   }
 
   uint8_t Vtf::getFaces() const {
-    if ((header.flags & TextureFlags::ENVMAP) == TextureFlags::NONE) {
-      return 1;
-    }
-
-    return header.firstFrame == 0xffff && header.version[1] < 5 ? 7 : 6;
+    return getFaceCount(header);
   }
 
   uint8_t Vtf::getMipLevels() const {
@@ -237,33 +277,108 @@ namespace VtfParser {
     const uint8_t face,
     const uint16_t depth
   ) const {
-    const auto targetExtent = getHighResImageExtent(mipLevel);
-    const ImageSizeInfo targetMipSize = {
-      .format = getHighResImageFormat(),
-      .width = targetExtent.width,
-      .height = targetExtent.height,
-      .depth = targetExtent.depth,
-      .faces = getFaces(),
-      .frames = getFrames(),
-      .mipLevels = getMipLevels(),
-    };
+    const auto& layout = getMipLayout(mipLevel);
+
+    return layout.offset + layout.frameSizeBytes * frame + layout.faceSizeBytes * face + layout.sliceSizeBytes * depth;
+  }
+
+  size_t Vtf::getImageSliceSizeBytes(const uint8_t mipLevel) const {
+    return getMipLayout(mipLevel).sliceSizeBytes;
+  }
+
+  std::span<const std::byte> Vtf::getImageSlice(
+    const uint8_t mipLevel,
+    const uint16_t frame,
+    const uint8_t face,
+    const uint16_t depth
+  ) const {
+    checkSliceExists(mipLevel, frame, face, depth);
+
+    return getDataRange(
+      highResImageData,
+      getImageSliceOffset(mipLevel, frame, face, depth),
+      getImageSliceSizeBytes(mipLevel),
+      "VTF image slice is outside of the high res image data"
+    );
+  }
+
+  std::span<const std::byte> Vtf::getImageSlice(
+    const std::span<const std::byte> mipData,
+    const uint8_t mipLevel,
+    const uint16_t frame,
+    const uint8_t face,
+    const uint16_t depth
+  ) const {
+    checkSliceExists(mipLevel, frame, face, depth);
 
-    size_t offset = 0;
-    for (uint8_t i = mipLevel + 1; i < targetMipSize.mipLevels; i++) {
-      const auto mipExtent = getHighResImageExtent(i);
-      auto mipSize = targetMipSize;
-      mipSize.width = mipExtent.width;
-      mipSize.height = mipExtent.height;
-      mipSize.depth = mipExtent.depth;
+    return getDataRange(
+      mipData,
+      getImageSliceOffset(mipLevel, frame, face, depth) - getMipLayout(mipLevel).offset,
+      getImageSliceSizeBytes(mipLevel),
+      "VTF image slice is outside of the given mip data"
+    );
+  }
 
-      offset += getMipSizeBytes(mipSize);
+  Vtf::SliceRange Vtf::getImageSlices() const {
+    if (mipLayouts.empty() || getFrames() == 0) {
+      return {};
     }
 
-    offset += getFrameSizeBytes(targetMipSize) * frame;
-    offset += getFaceSizeBytes(targetMipSize) * face;
-    offset += getSliceSizeBytes(targetMipSize) * depth;
+    if (highResImageData.size() < highResImageRange.size) {
+      throw OutOfBoundsAccess("VTF high res image data is not loaded");
+    }
+
+    size_t count = 0;
+    for (uint8_t mipLevel = 0; mipLevel < getMipLevels(); mipLevel++) {
+      count += getSliceCount(mipLevel);
+    }
 
-    return offset;
+    const auto smallestMip = static_cast<uint8_t>(getMipLevels() - 1);
+    return { SliceIterator(*this, highResImageData, mipLayouts[smallestMip].offset, smallestMip, 0), count };
+  }
+
+  Vtf::SliceRange Vtf::getImageSlices(const uint8_t mipLevel) const {
+    const auto& layout = getMipLayout(mipLevel);
+    if (getFrames() == 0) {
+      return {};
+    }
+
+    const auto mipData = getDataRange(
+      highResImageData,
+      layout.offset,
+      layout.sizeBytes,
+      "VTF mip level is outside of the high res image data"
+    );
+    return { SliceIterator(*this, mipData, 0, mipLevel, mipLevel), getSliceCount(mipLevel) };
+  }
+
+  Vtf::SliceRange Vtf::getImageSlices(const std::span<const std::byte> mipData, const uint8_t mipLevel) const {
+    const auto& layout = getMipLayout(mipLevel);
+    if (getFrames() == 0) {
+      return {};
+    }
+
+    if (mipData.size() < layout.sizeBytes) {
+      throw OutOfBoundsAccess("Given mip data is too short for the VTF mip level");
+    }
+    return { SliceIterator(*this, mipData, 0, mipLevel, mipLevel), getSliceCount(mipLevel) };
+  }
+
+  Vtf::ByteRange Vtf::getMipByteRange(const uint8_t mipLevel) const {
+    const auto& layout = getMipLayout(mipLevel);
+
+    return {
+      .offset = highResImageRange.offset + layout.offset,
+      .size = layout.sizeBytes,
+    };
+  }
+
+  Vtf::ByteRange Vtf::getHighResImageByteRange() const {
+    return highResImageRange;
+  }
+
+  Vtf::ByteRange Vtf::getLowResImageByteRange() const {
+    return lowResImageRange;
   }
 
   ImageFormat Vtf::getLowResImageFormat() const {
@@ -280,4 +395,132 @@ namespace VtfParser {
   std::span<const std::byte> Vtf::getLowResImageData() const {
     return lowResImageData;
   }
+
+  std::span<const Vtf::Resource> Vtf::getResources() const {
+    return resources;
+  }
+
+  const Vtf::Resource* Vtf::findResource(const std::array<uint8_t, 3>& tag) const {
+    const auto it = std::ranges::find(resources, tag, &Resource::tag);
+
+    return it == resources.end() ? nullptr : &*it;
+  }
+
+  std::optional<uint32_t> Vtf::getCrc() const {
+    return getInlineResourceValue<uint32_t>(ResourceTags::CRC);
+  }
+
+  std::optional<LodControlResource> Vtf::getLodControl() const {
+    return getInlineResourceValue<LodControlResource>(ResourceTags::LOD_CONTROL);
+  }
+
+  std::optional<uint32_t> Vtf::getExtendedFlags() const {
+    return getInlineResourceValue<uint32_t>(ResourceTags::EXTENDED_FLAGS);
+  }
+
+  std::optional<std::string_view> Vtf::getKeyValueData() const {
+    const auto* resource = findResource(ResourceTags::KEY_VALUE_DATA);
+    if (!resource || resource->data.empty()) {
+      return std::nullopt;
+    }
+
+    const std::string_view text(reinterpret_cast<const char*>(resource->data.data()), resource->data.size());
+    // Some writers include the null terminator in the chunk
+    return text.substr(0, text.find('\0'));
+  }
+
+  std::optional<Sheet> Vtf::getSheet() const {
+    const auto* resource = findResource(ResourceTags::SHEET);
+    if (!resource || resource->data.empty()) {
+      return std::nullopt;
+    }
+
+    return parseSheet(resource->data);
+  }
+
+  template<typename T>
+  std::optional<T> Vtf::getInlineResourceValue(const std::array<uint8_t, 3>& tag) const {
+    static_assert(sizeof(T) == sizeof(uint32_t));
+
+    const auto* resource = findResource(tag);
+    if (!resource || (resource->flags & RESOURCE_FLAG_NO_DATA_CHUNK) == 0) {
+      return std::nullopt;
+    }
+
+    T value;
+    std::memcpy(&value, &resource->value, sizeof(T));
+
+    return value;
+  }
+
+  void Vtf::checkSliceExists(
+    const uint8_t mipLevel,
+    const uint16_t frame,
+    const uint8_t face,
+    const uint16_t depth
+  ) const {
+    if (mipLevel >= getMipLevels() || frame >= getFrames() || face >= getFaces() || depth >= getHighResImageExtent(
+      mipLevel).depth) {
+      throw OutOfBoundsAccess("Requested VTF image slice does not exist");
+    }
+  }
+
+  size_t Vtf::getSliceCount(const uint8_t mipLevel) const {
+    return static_cast<size_t>(getFrames()) * getFaces() * getHighResImageExtent(mipLevel).depth;
+  }
+
+  Vtf::SliceIterator::SliceIterator(
+    const Vtf& vtf,
+    const std::span<const std::byte> data,
+    const size_t offset,
+    const uint8_t firstMip,
+    const uint8_t lastMip
+  ) : vtf(&vtf), data(data), offset(offset), lastMip(lastMip) {
+    slice.mipLevel = firstMip;
+    updateSlice();
+  }
+
+  Vtf::SliceIterator& Vtf::SliceIterator::operator++() {
+    index++;
+    offset += slice.data.size();
+
+    if (++slice.depth < mipDepth) {
+      updateSlice();
+      return *this;
+    }
+    slice.depth = 0;
+
+    if (++slice.face < vtf->getFaces()) {
+      updateSlice();
+      return *this;
+    }
+    slice.face = 0;
+
+    if (++slice.frame < vtf->getFrames()) {
+      updateSlice();
+      return *this;
+    }
+    slice.frame = 0;
+
+    // Mips are stored smallest first, so the next mip in storage order is the next largest
+    if (slice.mipLevel != lastMip) {
+      slice.mipLevel--;
+      updateSlice();
+    }
+
+    return *this;
+  }
+
+  void Vtf::SliceIterator::updateSlice() {
+    mipDepth = vtf->getHighResImageExtent(slice.mipLevel).depth;
+    slice.data = data.subspan(offset, vtf->mipLayouts[slice.mipLevel].sliceSizeBytes);
+  }
+
+  const Vtf::MipLayout& Vtf::getMipLayout(const uint8_t mipLevel) const {
+    if (mipLevel >= mipLayouts.size()) {
+      throw OutOfBoundsAccess("Requested VTF mip level does not exist");
+    }
+
+    return mipLayouts[mipLevel];
+  }
 }
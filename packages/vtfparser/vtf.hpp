@@ -1,9 +1,16 @@
 #pragma once
 
 #include <cstdint>
+#include <iterator>
 #include <memory>
+#include <optional>
+#include <ranges>
 #include <span>
+#include <string_view>
+#include <vector>
 #include "file-format-objects/header.hpp"
+#include "file-format-objects/resources.hpp"
+#include "sheet.hpp"
 
 namespace VtfParser {
   /**
@@ -43,12 +50,222 @@ namespace VtfParser {
       uint16_t depth;
     };
 
+    /**
+     * How much of the file is expected to be given to the constructor.
+     */
+    enum class LoadMode : uint8_t {
+      /**
+       * The whole file is given, and image data can be accessed directly.
+       */
+      Full,
+      /**
+       * Only the header and resource table are given. Image data must be fetched separately, using the byte ranges
+       * reported by getMipByteRange(), getHighResImageByteRange() and getLowResImageByteRange().
+       */
+      HeaderOnly
+    };
+
+    /**
+     * Range of bytes within the VTF file.
+     */
+    struct ByteRange {
+      /**
+       * Offset from the start of the file in bytes.
+       */
+      size_t offset;
+      /**
+       * Size of the range in bytes.
+       */
+      size_t size;
+    };
+
+    /**
+     * Entry in the resource table of a 7.3+ VTF.
+     */
+    struct Resource {
+      /**
+       * Three-byte tag identifying the resource. Standard tags are listed in ResourceTags.
+       */
+      std::array<uint8_t, 3> tag;
+      /**
+       * Resource entry flags, e.g. RESOURCE_FLAG_NO_DATA_CHUNK.
+       */
+      uint8_t flags;
+      /**
+       * Raw value of the entry: the resource's value if it has no data chunk, otherwise the offset of its data.
+       */
+      uint32_t value;
+      /**
+       * View over the resource's data chunk (excluding its size prefix).
+       * Empty if the resource has no data chunk, or for LoadMode::HeaderOnly.
+       */
+      std::span<const std::byte> data;
+    };
+
+    /**
+     * One 2D slice of the high resolution image, as yielded by getImageSlices().
+     */
+    struct ImageSlice {
+      uint8_t mipLevel;
+      uint16_t frame;
+      uint8_t face;
+      /**
+       * Depth or Z value of a volumetric texture. Always 0 for 2D textures.
+       */
+      uint16_t depth;
+      /**
+       * View over the slice, in the format returned by getHighResImageFormat().
+       */
+      std::span<const std::byte> data;
+    };
+
+    /**
+     * Forward iterator over image slices in storage order: smallest mip first, then frame, face and depth.
+     * Each step advances past the previous slice, so no offsets are recomputed.
+     */
+    class SliceIterator {
+    public:
+      using iterator_category = std::forward_iterator_tag;
+      using value_type = ImageSlice;
+      using difference_type = std::ptrdiff_t;
+      using pointer = const ImageSlice*;
+      using reference = const ImageSlice&;
+
+      SliceIterator() = default;
+
+      reference operator*() const {
+        return slice;
+      }
+
+      pointer operator->() const {
+        return &slice;
+      }
+
+      SliceIterator& operator++();
+
+      SliceIterator operator++(int) {
+        auto previous = *this;
+        ++*this;
+        return previous;
+      }
+
+      bool operator==(const SliceIterator& other) const {
+        return index == other.index;
+      }
+
+    private:
+      friend class Vtf;
+
+      SliceIterator(const Vtf& vtf, std::span<const std::byte> data, size_t offset, uint8_t firstMip, uint8_t lastMip);
+
+      /**
+       * End iterator, which only needs to match the index of the last slice plus one.
+       */
+      explicit SliceIterator(size_t index) : index(index) {}
+
+      void updateSlice();
+
+      const Vtf* vtf = nullptr;
+      std::span<const std::byte> data;
+      size_t offset = 0;
+      size_t index = 0;
+      uint8_t lastMip = 0;
+      uint16_t mipDepth = 0;
+      ImageSlice slice{};
+    };
+
+    /**
+     * Range of image slices, usable with range-based for loops and std::ranges algorithms.
+     */
+    class SliceRange : public std::ranges::view_interface<SliceRange> {
+    public:
+      SliceRange() = default;
+
+      SliceRange(const SliceIterator first, const size_t count) : first(first), count(count) {}
+
+      [[nodiscard]] SliceIterator begin() const {
+        return first;
+      }
+
+      [[nodiscard]] SliceIterator end() const {
+        return SliceIterator(count);
+      }
+
+      /**
+       * Gets the number of slices in the range.
+       */
+      [[nodiscard]] size_t size() const {
+        return count;
+      }
+
+    private:
+      SliceIterator first;
+      size_t count = 0;
+    };
+
+    /**
+     * Summary of the header returned by probe(), without any of the image layout.
+     */
+    struct HeaderSummary {
+      /**
+       * File format version. Index zero is MAJOR and one is MINOR.
+       */
+      std::array<uint32_t, 2> version;
+      /**
+       * Format of the high resolution image.
+       */
+      ImageFormat format;
+      /**
+       * Extent of the largest mip level.
+       */
+      HighResImageExtent extent;
+      uint8_t mipLevels;
+      uint16_t frames;
+      /**
+       * 6 or 7 for cubemaps (depending on version) and 1 for anything else.
+       */
+      uint8_t faces;
+      TextureFlags flags;
+      /**
+       * Format of the low resolution image. NONE if the texture has no thumbnail.
+       */
+      ImageFormat lowResImageFormat;
+      LowResImageExtent lowResImageExtent;
+    };
+
+    /**
+     * Size of the largest possible header, including a full resource table.
+     * Reading this many bytes (or the whole file, if it is shorter) is always enough for LoadMode::HeaderOnly.
+     */
+    static constexpr size_t MAX_HEADER_SIZE = sizeof(Header);
+
+    /**
+     * Size of the header without its resource table.
+     * Reading this many bytes (or the whole file, if it is shorter) is always enough for probe().
+     */
+    static constexpr size_t PROBE_SIZE = sizeof(HeaderFullAligned);
+
+    /**
+     * Validates the header and summarises the texture, without computing the image layout or reading any resources.
+     * @remark Intended for bulk scanning, where only the format and extent of each texture are needed.
+     * @param data Start of the file. Only the first PROBE_SIZE bytes are read.
+     * @return Summary of the header.
+     * @throws Errors::InvalidHeader The header is malformed.
+     * @throws Errors::UnsupportedVersion The VTF version is not supported.
+     * @throws Errors::OutOfBoundsAccess The data is too short for the header.
+     */
+    [[nodiscard]] static HeaderSummary probe(std::span<const std::byte> data);
+
     /**
      * Loads the VTF given by the binary data into an easily accessible structure.
      * Does not take ownership of the data.
-     * @param data
+     * @param data Whole file, or a prefix containing at least the header and resource table for LoadMode::HeaderOnly.
+     * @param loadMode Whether data holds the whole file or only its header.
+     * @throws Errors::InvalidHeader The header is malformed.
+     * @throws Errors::UnsupportedVersion The VTF version is not supported.
+     * @throws Errors::OutOfBoundsAccess The data is too short for the header, or for the image data in LoadMode::Full.
      */
-    explicit Vtf(std::span<const std::byte> data);
+    explicit Vtf(std::span<const std::byte> data, LoadMode loadMode = LoadMode::Full);
 
     /**
      * Gets the format of the high resolution image data.
@@ -94,7 +311,7 @@ namespace VtfParser {
 
     /**
      * Gets the high resolution image data.
-     * @return View over the high-res data.
+     * @return View over the high-res data. Empty for LoadMode::HeaderOnly.
      */
     [[nodiscard]] std::span<const std::byte> getHighResImageData() const;
 
@@ -107,6 +324,7 @@ namespace VtfParser {
      * @param face Face of a cubemap.
      * @param depth Depth or Z value of a volumetric texture.
      * @return Offset (in bytes) into the data returned by getHighResImageData().
+     * @throws Errors::OutOfBoundsAccess The mip level does not exist.
      */
     [[nodiscard]] size_t getImageSliceOffset(
       uint8_t mipLevel = 0,
@@ -115,6 +333,98 @@ namespace VtfParser {
       uint16_t depth = 0
     ) const;
 
+    /**
+     * Gets the size of each image slice at the given mipmap level.
+     * @param mipLevel Level of the mipmap chain.
+     * @return Size (in bytes) of one 2D image in the high res image data.
+     * @throws Errors::OutOfBoundsAccess The mip level does not exist.
+     */
+    [[nodiscard]] size_t getImageSliceSizeBytes(uint8_t mipLevel = 0) const;
+
+    /**
+     * Gets the data of an image slice at the given mipmap level, animation frame, cubemap face and depth.
+     * @param mipLevel Level of the mipmap chain.
+     * @param frame Frame of animation.
+     * @param face Face of a cubemap.
+     * @param depth Depth or Z value of a volumetric texture.
+     * @return View over the slice, in the format returned by getHighResImageFormat().
+     * @throws Errors::OutOfBoundsAccess The slice does not exist.
+     */
+    [[nodiscard]] std::span<const std::byte> getImageSlice(
+      uint8_t mipLevel = 0,
+      uint16_t frame = 0,
+      uint8_t face = 0,
+      uint16_t depth = 0
+    ) const;
+
+    /**
+     * Gets a slice from the data of a single mip level, fetched separately using getMipByteRange().
+     * @remark Intended for use with LoadMode::HeaderOnly.
+     * @param mipData Data of the whole mip level.
+     * @param mipLevel Level of the mipmap chain mipData belongs to.
+     * @param frame Frame of animation.
+     * @param face Face of a cubemap.
+     * @param depth Depth or Z value of a volumetric texture.
+     * @return View over the slice, in the format returned by getHighResImageFormat().
+     * @throws Errors::OutOfBoundsAccess The slice does not exist, or mipData is too short.
+     */
+    [[nodiscard]] std::span<const std::byte> getImageSlice(
+      std::span<const std::byte> mipData,
+      uint8_t mipLevel,
+      uint16_t frame = 0,
+      uint8_t face = 0,
+      uint16_t depth = 0
+    ) const;
+
+    /**
+     * Gets every slice of every mip level, in storage order (smallest mip first, then frame, face and depth).
+     * @remark Consecutive slices are adjacent in getHighResImageData(), so the whole range can also be copied in one
+     * @remark pass, e.g. into a 3D or array GPU texture.
+     * @return Range of slices.
+     * @throws Errors::OutOfBoundsAccess The high res image data is truncated, or was not loaded (LoadMode::HeaderOnly).
+     */
+    [[nodiscard]] SliceRange getImageSlices() const;
+
+    /**
+     * Gets every slice of a single mip level, in storage order (frame, then face, then depth).
+     * @param mipLevel Level of the mipmap chain.
+     * @return Range of slices.
+     * @throws Errors::OutOfBoundsAccess The mip level does not exist, or its data is truncated or was not loaded.
+     */
+    [[nodiscard]] SliceRange getImageSlices(uint8_t mipLevel) const;
+
+    /**
+     * Gets every slice of a single mip level from its data, fetched separately using getMipByteRange().
+     * @remark Intended for use with LoadMode::HeaderOnly.
+     * @param mipData Data of the whole mip level.
+     * @param mipLevel Level of the mipmap chain mipData belongs to.
+     * @return Range of slices, viewing mipData.
+     * @throws Errors::OutOfBoundsAccess The mip level does not exist, or mipData is too short.
+     */
+    [[nodiscard]] SliceRange getImageSlices(std::span<const std::byte> mipData, uint8_t mipLevel) const;
+
+    /**
+     * Gets the range of the file holding every frame, face and depth slice of a mip level.
+     * @remark Mips are stored smallest first, so the ranges of the smallest mips up to any given level are contiguous
+     * @remark and can be fetched progressively.
+     * @param mipLevel Level of the mipmap chain.
+     * @return Offset and size of the mip level within the file.
+     * @throws Errors::OutOfBoundsAccess The mip level does not exist.
+     */
+    [[nodiscard]] ByteRange getMipByteRange(uint8_t mipLevel) const;
+
+    /**
+     * Gets the range of the file holding the high resolution image data.
+     * @return Offset and size of the high res data within the file.
+     */
+    [[nodiscard]] ByteRange getHighResImageByteRange() const;
+
+    /**
+     * Gets the range of the file holding the low resolution image data.
+     * @return Offset and size of the low res data within the file, or an empty range if there is no low res image.
+     */
+    [[nodiscard]] ByteRange getLowResImageByteRange() const;
+
     /**
      * Gets the format of the low resolution image data.
      * @remark This is almost always DXT1.
@@ -131,13 +441,87 @@ namespace VtfParser {
 
     /**
      * Gets the low resolution image data.
-     * @return View over the low res data.
+     * @return View over the low res data. Empty for LoadMode::HeaderOnly.
      */
     [[nodiscard]] std::span<const std::byte> getLowResImageData() const;
 
+    /**
+     * Gets every entry in the resource table, in file order.
+     * @return View over the resources. Empty before version 7.3.
+     */
+    [[nodiscard]] std::span<const Resource> getResources() const;
+
+    /**
+     * Finds the first resource with the given tag.
+     * @param tag Resource tag, e.g. one of ResourceTags.
+     * @return Pointer to the resource, or nullptr if the VTF doesn't have it.
+     */
+    [[nodiscard]] const Resource* findResource(const std::array<uint8_t, 3>& tag) const;
+
+    /**
+     * Gets the CRC32 of the source image, from the CRC resource.
+     * @return CRC, or nothing if the resource is not present.
+     */
+    [[nodiscard]] std::optional<uint32_t> getCrc() const;
+
+    /**
+     * Gets the resolution clamps from the LOD control resource.
+     * @return LOD control, or nothing if the resource is not present.
+     */
+    [[nodiscard]] std::optional<LodControlResource> getLodControl() const;
+
+    /**
+     * Gets the texture settings extended flags, from the TSO resource.
+     * @return Extended flags, or nothing if the resource is not present.
+     */
+    [[nodiscard]] std::optional<uint32_t> getExtendedFlags() const;
+
+    /**
+     * Gets the key-value (VDF) text stored in the KVD resource.
+     * @remark The text is not parsed, so it can be passed to a VDF parser of your choice.
+     * @return View over the text, or nothing if the resource is not present (or the VTF was loaded header only).
+     */
+    [[nodiscard]] std::optional<std::string_view> getKeyValueData() const;
+
+    /**
+     * Decodes the sheet resource used by animated sprites into its sequences and frames.
+     * @remark The sheet is decoded on each call, so keep the result if it is needed repeatedly.
+     * @return Sheet, or nothing if the resource is not present (or the VTF was loaded header only).
+     * @throws Errors::InvalidBody The sheet version is unknown.
+     * @throws Errors::OutOfBoundsAccess The sheet data is truncated.
+     */
+    [[nodiscard]] std::optional<Sheet> getSheet() const;
+
   private:
+    /**
+     * Precomputed location of a mip level within the high res image data, so slices can be found without walking
+     * the mip chain.
+     */
+    struct MipLayout {
+      size_t offset;
+      size_t frameSizeBytes;
+      size_t faceSizeBytes;
+      size_t sliceSizeBytes;
+      size_t sizeBytes;
+    };
+
+    template<typename T>
+    [[nodiscard]] std::optional<T> getInlineResourceValue(const std::array<uint8_t, 3>& tag) const;
+
+    void checkSliceExists(uint8_t mipLevel, uint16_t frame, uint8_t face, uint16_t depth) const;
+
+    [[nodiscard]] const MipLayout& getMipLayout(uint8_t mipLevel) const;
+
+    [[nodiscard]] size_t getSliceCount(uint8_t mipLevel) const;
+
     Header header{};
 
+    std::vector<MipLayout> mipLayouts;
+    std::vector<Resource> resources;
+
+    ByteRange highResImageRange{};
+    ByteRange lowResImageRange{};
+
     std::span<const std::byte> highResImageData;
     std::span<const std::byte> lowResImageData;
   };
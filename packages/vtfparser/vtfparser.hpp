@@ -6,3 +6,7 @@
 namespace VtfParser {}
 
 #include "vtf.hpp"
+#include "decode.hpp"
+#include "sheet.hpp"
+#include "mip-chain.hpp"
+#include "writer.hpp"
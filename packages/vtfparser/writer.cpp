@@ -0,0 +1,397 @@
+#include "writer.hpp"
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <source-parsers-shared/errors.hpp>
+#include <source-parsers-shared/internal/parallel-for.hpp>
+#include "encoders/block-compressed.hpp"
+#include "file-format-objects/header.hpp"
+#include "file-format-objects/resources.hpp"
+#include "helpers/image-sizes.hpp"
+#include "helpers/srgb.hpp"
+
+namespace VtfParser {
+  using namespace SourceParsers::Errors;
+  using namespace SourceParsers::Internal;
+  using namespace VtfParser::Internal;
+
+  namespace {
+    constexpr std::array<uint8_t, 4> FILE_ID = { 'V', 'T', 'F', 0 };
+    constexpr std::array<uint32_t, 2> WRITTEN_VERSION = { 7, 5 };
+
+    constexpr size_t RGBA8_PIXEL_SIZE = 4;
+    constexpr size_t HEADER_SIZE = sizeof(Header) - Header::MAX_RESOURCES * sizeof(ResourceEntryInfo);
+
+    /**
+     * Largest extent of the low resolution image, matching what Valve's tools write.
+     */
+    constexpr uint32_t MAX_THUMBNAIL_EXTENT = 16;
+
+    /**
+     * Rows processed by each mip generation and compression job. A multiple of 4, so bands of block compressed
+     * images start on a block boundary.
+     */
+    constexpr uint32_t ENCODE_BAND_ROWS = 64;
+
+    struct Extent {
+      uint32_t width;
+      uint32_t height;
+    };
+
+    /**
+     * Where everything goes in the output, worked out before any pixels are touched.
+     */
+    struct Layout {
+      ImageFormat format;
+      TextureFlags flags;
+      uint32_t slices;
+      uint8_t mipLevels;
+      Extent thumbnailExtent{};
+      size_t thumbnailOffset = 0;
+      size_t thumbnailSizeBytes = 0;
+      size_t highResOffset = 0;
+      size_t highResSizeBytes = 0;
+      uint32_t numResources = 0;
+
+      [[nodiscard]] size_t getHeaderSize() const {
+        return HEADER_SIZE + numResources * sizeof(ResourceEntryInfo);
+      }
+
+      [[nodiscard]] size_t getSize() const {
+        return highResOffset + highResSizeBytes;
+      }
+    };
+
+    Extent getMipExtent(const WriterImage& image, const uint8_t mipLevel) {
+      return { std::max<uint32_t>(image.width >> mipLevel, 1), std::max<uint32_t>(image.height >> mipLevel, 1) };
+    }
+
+    ImageSizeInfo getImageSizeInfo(const WriterImage& image, const ImageFormat format, const uint8_t mipLevels) {
+      return {
+        .format = format,
+        .width = image.width,
+        .height = image.height,
+        .depth = 1,
+        .faces = image.faces,
+        .frames = image.frames,
+        .mipLevels = mipLevels,
+      };
+    }
+
+    TextureFlags getImpliedFlags(const WriterImage& image, const ImageFormat format) {
+      auto flags = format == ImageFormat::DXT1_ONEBITALPHA ? TextureFlags::ONEBITALPHA :
+        format == ImageFormat::DXT1                        ? TextureFlags::NONE :
+                                                             TextureFlags::EIGHTBITALPHA;
+      if (image.faces == 6) {
+        flags = flags | TextureFlags::ENVMAP;
+      }
+
+      return flags;
+    }
+
+    Layout getLayout(const WriterImage& image, const WriterOptions& options) {
+      switch (options.format) {
+        case ImageFormat::DXT1:
+        case ImageFormat::DXT1_ONEBITALPHA:
+        case ImageFormat::DXT5:
+        case ImageFormat::RGBA8888:
+        case ImageFormat::BGRA8888:
+          break;
+        default:
+          throw UnsupportedFormat("VTF can only be written as DXT1, DXT1_ONEBITALPHA, DXT5, RGBA8888 or BGRA8888");
+      }
+
+      if (image.faces != 1 && image.faces != 6) {
+        throw UnsupportedFormat("VTF can only be written with 1 face, or 6 for an environment map");
+      }
+
+      if (image.width == 0 || image.height == 0 || image.frames == 0) {
+        throw OutOfBoundsAccess("Image to write has no pixels");
+      }
+
+      Layout layout{
+        .format = options.format,
+        .flags = options.flags | getImpliedFlags(image, options.format),
+        .slices = static_cast<uint32_t>(image.frames) * image.faces,
+        .mipLevels = options.generateMips ? getFullMipLevels(image.width, image.height) : uint8_t{ 1 },
+      };
+
+      if (image.rgba8.size() / RGBA8_PIXEL_SIZE / layout.slices / image.width < image.height) {
+        throw OutOfBoundsAccess("Image data is too short for the given extent");
+      }
+
+      if (options.generateThumbnail) {
+        uint8_t thumbnailMip = 0;
+        while (static_cast<uint32_t>(std::max(image.width, image.height) >> thumbnailMip) > MAX_THUMBNAIL_EXTENT) {
+          thumbnailMip++;
+        }
+
+        layout.thumbnailExtent = getMipExtent(image, thumbnailMip);
+        layout.thumbnailSizeBytes = getCompressedSizeBytes(
+          layout.thumbnailExtent.width,
+          layout.thumbnailExtent.height,
+          getBlockSizeBytes(ImageFormat::DXT1)
+        );
+        layout.numResources++;
+      }
+
+      layout.highResSizeBytes = getImageSizeBytes(getImageSizeInfo(image, layout.format, layout.mipLevels));
+      layout.numResources++;
+
+      layout.thumbnailOffset = layout.getHeaderSize();
+      layout.highResOffset = layout.thumbnailOffset + layout.thumbnailSizeBytes;
+
+      return layout;
+    }
+
+    /**
+     * Average linear colour of the source image, which the engine uses for radiosity.
+     * Channels which aren't sRGB encoded are averaged as is.
+     */
+    std::array<float, 3> getReflectivity(const std::span<const std::byte> pixels, const bool srgb) {
+      std::array<double, 3> sum{};
+      for (size_t offset = 0; offset < pixels.size(); offset += RGBA8_PIXEL_SIZE) {
+        for (size_t c = 0; c < sum.size(); c++) {
+          const auto value = static_cast<uint8_t>(pixels[offset + c]);
+          sum[c] += srgb ? srgbToLinear(value) : value / 255.0f;
+        }
+      }
+
+      const auto pixelCount = static_cast<double>(pixels.size() / RGBA8_PIXEL_SIZE);
+      return {
+        static_cast<float>(sum[0] / pixelCount),
+        static_cast<float>(sum[1] / pixelCount),
+        static_cast<float>(sum[2] / pixelCount),
+      };
+    }
+
+    uint32_t getBandCount(const uint32_t height) {
+      return (height + ENCODE_BAND_ROWS - 1) / ENCODE_BAND_ROWS;
+    }
+
+    /**
+     * Encodes rows of RGBA8 pixels in the output format.
+     * @param pixels First row of the band.
+     * @param output Where the first row of the band is stored in the output format.
+     */
+    void encodeRows(
+      const ImageFormat format,
+      const CompressionQuality quality,
+      const std::span<const std::byte> pixels,
+      const uint32_t width,
+      const uint32_t rows,
+      const std::span<std::byte> output
+    ) {
+      const auto blockQuality = static_cast<BlockQuality>(quality);
+
+      switch (format) {
+        case ImageFormat::DXT1:
+          encodeDxt1(pixels, width, rows, false, blockQuality, output);
+          break;
+        case ImageFormat::DXT1_ONEBITALPHA:
+          encodeDxt1(pixels, width, rows, true, blockQuality, output);
+          break;
+        case ImageFormat::DXT5:
+          encodeDxt5(pixels, width, rows, blockQuality, output);
+          break;
+        case ImageFormat::BGRA8888:
+          for (size_t offset = 0; offset < static_cast<size_t>(width) * rows * RGBA8_PIXEL_SIZE;
+               offset += RGBA8_PIXEL_SIZE) {
+            output[offset] = pixels[offset + 2];
+            output[offset + 1] = pixels[offset + 1];
+            output[offset + 2] = pixels[offset];
+            output[offset + 3] = pixels[offset + 3];
+          }
+          break;
+        default:
+          std::memcpy(output.data(), pixels.data(), static_cast<size_t>(width) * rows * RGBA8_PIXEL_SIZE);
+          break;
+      }
+    }
+
+    /**
+     * Gets the offset of a row within an image slice in the given format. Rows of block compressed formats must be
+     * on a block boundary.
+     */
+    size_t getRowOffset(const ImageFormat format, const uint32_t width, const uint32_t row) {
+      if (isBlockCompressed(format)) {
+        return getCompressedSizeBytes(width, row, getBlockSizeBytes(format));
+      }
+
+      return static_cast<size_t>(width) * row * getPixelSizeBytes(format);
+    }
+
+    void writeHighResImage(
+      const WriterImage& image,
+      const Layout& layout,
+      const WriterOptions& options,
+      const std::span<std::byte> output
+    ) {
+      const MipChainSource mipSource = { .data = image.rgba8, .width = image.width, .height = image.height,
+                                         .frames = image.frames, .faces = image.faces };
+      const MipChainOptions mipOptions = { .filter = options.mipFilter, .srgb = options.srgb,
+                                           .mipLevels = layout.mipLevels, .threadCount = options.threadCount };
+
+      // The mip chain is already in the output layout when no conversion is needed
+      if (layout.format == ImageFormat::RGBA8888) {
+        generateMipChain(mipSource, output, mipOptions);
+        return;
+      }
+
+      std::vector<std::byte> mipChain;
+      if (layout.mipLevels > 1) {
+        mipChain = generateMipChain(mipSource, mipOptions);
+      }
+      const auto pixels = layout.mipLevels > 1 ? std::span<const std::byte>(mipChain) : image.rgba8;
+
+      struct Job {
+        uint8_t mipLevel;
+        uint32_t slice;
+        uint32_t firstRow;
+      };
+
+      // Largest mip first, so the most expensive jobs are claimed before the cheap ones
+      std::vector<Job> jobs;
+      for (uint8_t mipLevel = 0; mipLevel < layout.mipLevels; mipLevel++) {
+        const auto bands = getBandCount(getMipExtent(image, mipLevel).height);
+        for (uint32_t slice = 0; slice < layout.slices; slice++) {
+          for (uint32_t band = 0; band < bands; band++) {
+            jobs.push_back({ mipLevel, slice, band * ENCODE_BAND_ROWS });
+          }
+        }
+      }
+
+      const auto sourceSizeInfo = getImageSizeInfo(image, ImageFormat::RGBA8888, layout.mipLevels);
+      const auto outputSizeInfo = getImageSizeInfo(image, layout.format, layout.mipLevels);
+
+      parallelFor(jobs.size(), options.threadCount, [&](const size_t index) {
+        const auto& job = jobs[index];
+        const auto extent = getMipExtent(image, job.mipLevel);
+        const auto rows = std::min(ENCODE_BAND_ROWS, extent.height - job.firstRow);
+
+        const auto sourceOffset = getMipOffsetBytes(sourceSizeInfo, job.mipLevel) +
+          job.slice * getSliceSizeBytes(getMipSizeInfo(sourceSizeInfo, job.mipLevel)) +
+          static_cast<size_t>(job.firstRow) * extent.width * RGBA8_PIXEL_SIZE;
+        const auto outputOffset = getMipOffsetBytes(outputSizeInfo, job.mipLevel) +
+          job.slice * getSliceSizeBytes(getMipSizeInfo(outputSizeInfo, job.mipLevel)) +
+          getRowOffset(layout.format, extent.width, job.firstRow);
+
+        encodeRows(
+          layout.format,
+          options.quality,
+          pixels.subspan(sourceOffset, static_cast<size_t>(rows) * extent.width * RGBA8_PIXEL_SIZE),
+          extent.width,
+          rows,
+          output.subspan(outputOffset, getRowOffset(layout.format, extent.width, rows))
+        );
+      });
+    }
+
+    /**
+     * Writes the DXT1 low resolution image, box filtered from the first slice.
+     */
+    void writeThumbnail(const WriterImage& image, const Layout& layout, const std::span<std::byte> output) {
+      const auto [width, height] = layout.thumbnailExtent;
+      std::vector<std::byte> pixels(static_cast<size_t>(width) * height * RGBA8_PIXEL_SIZE);
+
+      const auto scaleX = image.width / width;
+      const auto scaleY = image.height / height;
+      for (uint32_t y = 0; y < height; y++) {
+        for (uint32_t x = 0; x < width; x++) {
+          std::array<uint32_t, RGBA8_PIXEL_SIZE> sum{};
+          for (uint32_t sourceY = y * scaleY; sourceY < (y + 1) * scaleY; sourceY++) {
+            for (uint32_t sourceX = x * scaleX; sourceX < (x + 1) * scaleX; sourceX++) {
+              const auto* pixel = &image.rgba8[(static_cast<size_t>(sourceY) * image.width + sourceX) * RGBA8_PIXEL_SIZE];
+              for (size_t c = 0; c < sum.size(); c++) {
+                sum[c] += static_cast<uint32_t>(pixel[c]);
+              }
+            }
+          }
+
+          const auto count = scaleX * scaleY;
+          for (size_t c = 0; c < sum.size(); c++) {
+            pixels[(static_cast<size_t>(y) * width + x) * RGBA8_PIXEL_SIZE + c] = static_cast<std::byte>(
+              (sum[c] + count / 2) / count
+            );
+          }
+        }
+      }
+
+      encodeDxt1(pixels, width, height, false, BlockQuality::Normal, output);
+    }
+
+    void writeHeader(
+      const WriterImage& image,
+      const Layout& layout,
+      const WriterOptions& options,
+      const std::span<std::byte> output
+    ) {
+      Header header{};
+      std::ranges::copy(FILE_ID, header.signature.begin());
+      header.version = WRITTEN_VERSION;
+      header.headerSize = static_cast<uint32_t>(layout.getHeaderSize());
+      header.width = image.width;
+      header.height = image.height;
+      header.flags = layout.flags;
+      header.frames = image.frames;
+      header.firstFrame = 0;
+      header.reflectivity = getReflectivity(
+        image.rgba8.subspan(0, static_cast<size_t>(image.width) * image.height * RGBA8_PIXEL_SIZE * layout.slices),
+        options.srgb
+      );
+      header.bumpmapScale = 1.0f;
+      header.highResImageFormat = layout.format;
+      header.mipmapCount = layout.mipLevels;
+      header.lowResImageFormat = layout.thumbnailSizeBytes > 0 ? ImageFormat::DXT1 : ImageFormat::NONE;
+      header.lowResImageWidth = static_cast<uint8_t>(layout.thumbnailSizeBytes > 0 ? layout.thumbnailExtent.width : 0);
+      header.lowResImageHeight = static_cast<uint8_t>(layout.thumbnailSizeBytes > 0 ? layout.thumbnailExtent.height : 0);
+      header.depth = 1;
+      header.numResources = layout.numResources;
+
+      size_t resource = 0;
+      const auto addResource = [&](const std::array<uint8_t, 3>& tag, const size_t offset) {
+        header.resourceInfos[resource++] = { .tag = tag, .flags = 0, .data = static_cast<uint32_t>(offset) };
+      };
+      if (layout.thumbnailSizeBytes > 0) {
+        addResource(ResourceTags::LOW_RES_IMAGE, layout.thumbnailOffset);
+      }
+      addResource(ResourceTags::HIGH_RES_IMAGE, layout.highResOffset);
+
+      std::memcpy(output.data(), &header, layout.getHeaderSize());
+    }
+
+    void write(const WriterImage& image, const Layout& layout, const WriterOptions& options, std::span<std::byte> output) {
+      writeHeader(image, layout, options, output);
+
+      if (layout.thumbnailSizeBytes > 0) {
+        writeThumbnail(image, layout, output.subspan(layout.thumbnailOffset, layout.thumbnailSizeBytes));
+      }
+
+      writeHighResImage(image, layout, options, output.subspan(layout.highResOffset, layout.highResSizeBytes));
+    }
+  }
+
+  size_t getVtfSize(const WriterImage& image, const WriterOptions& options) {
+    return getLayout(image, options).getSize();
+  }
+
+  size_t writeVtf(const WriterImage& image, const std::span<std::byte> buffer, const WriterOptions& options) {
+    const auto layout = getLayout(image, options);
+    if (layout.getSize() > buffer.size()) {
+      throw BufferTooSmall("Buffer is too small to hold the VTF");
+    }
+
+    write(image, layout, options, buffer);
+
+    return layout.getSize();
+  }
+
+  std::vector<std::byte> toVtf(const WriterImage& image, const WriterOptions& options) {
+    const auto layout = getLayout(image, options);
+    std::vector<std::byte> data(layout.getSize());
+
+    write(image, layout, options, data);
+
+    return data;
+  }
+}
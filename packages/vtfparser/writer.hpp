@@ -0,0 +1,110 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+#include "file-format-objects/enums.hpp"
+#include "mip-chain.hpp"
+
+namespace VtfParser {
+  /**
+   * How much effort the block compressor spends per 4x4 block. Has no effect on uncompressed formats.
+   */
+  enum class CompressionQuality : uint8_t {
+    /**
+     * Bounding box endpoints. Intended for bulk re-encoding, where throughput matters more than quality.
+     */
+    Fast,
+    /**
+     * Principal axis endpoints, which handle gradients and diagonal colour ranges much better than Fast.
+     */
+    Normal,
+    /**
+     * Principal axis endpoints refined by least squares fitting, and a second alpha mode tried for DXT5.
+     */
+    High
+  };
+
+  /**
+   * Options controlling how a VTF is written.
+   */
+  struct WriterOptions {
+    /**
+     * Format of the high resolution image. One of DXT1, DXT1_ONEBITALPHA, DXT5, RGBA8888 or BGRA8888.
+     */
+    ImageFormat format = ImageFormat::DXT5;
+    /**
+     * Flags to set in the header, in addition to the alpha and environment map flags implied by the other options.
+     */
+    TextureFlags flags = TextureFlags::NONE;
+    /**
+     * Whether to generate a full mip chain down to 1x1, rather than only writing the source image.
+     */
+    bool generateMips = true;
+    MipFilter mipFilter = MipFilter::Box;
+    /**
+     * Whether the source RGB channels are sRGB encoded, so mips are filtered in linear light. Set this to false for
+     * normal maps and other non-colour data.
+     */
+    bool srgb = true;
+    /**
+     * Whether to write the DXT1 low resolution image used as a thumbnail by tools.
+     */
+    bool generateThumbnail = true;
+    CompressionQuality quality = CompressionQuality::Normal;
+    /**
+     * Number of threads used for mip generation and compression. 0 uses the number of hardware threads.
+     */
+    unsigned int threadCount = 0;
+  };
+
+  /**
+   * Source image for the writer: mip 0 of every frame and face, as tightly packed RGBA8.
+   */
+  struct WriterImage {
+    /**
+     * Pixels of each slice one after another, frame by frame, then face by face within each frame.
+     */
+    std::span<const std::byte> rgba8;
+    uint16_t width;
+    uint16_t height;
+    uint16_t frames = 1;
+    /**
+     * 1 for a regular texture, or 6 for an environment map.
+     */
+    uint8_t faces = 1;
+  };
+
+  /**
+   * Computes the exact number of bytes writeVtf will produce, without compressing anything.
+   * @param image Source image.
+   * @param options Output options.
+   * @return Size of the VTF in bytes.
+   * @throws Errors::UnsupportedFormat The output format or face count cannot be written.
+   * @throws Errors::OutOfBoundsAccess The image has no pixels, or the source data is too short for its extent.
+   */
+  [[nodiscard]] size_t getVtfSize(const WriterImage& image, const WriterOptions& options = {});
+
+  /**
+   * Writes the image as a version 7.5 VTF into a caller-provided buffer.
+   * @param image Source image.
+   * @param buffer Destination buffer, which must be at least getVtfSize bytes long.
+   * @param options Output options.
+   * @return Number of bytes written.
+   * @throws Errors::UnsupportedFormat The output format or face count cannot be written.
+   * @throws Errors::OutOfBoundsAccess The image has no pixels, or the source data is too short for its extent.
+   * @throws Errors::BufferTooSmall The buffer cannot hold the output.
+   */
+  size_t writeVtf(const WriterImage& image, std::span<std::byte> buffer, const WriterOptions& options = {});
+
+  /**
+   * Writes the image as a version 7.5 VTF into a new buffer, allocated once at its final size.
+   * @param image Source image.
+   * @param options Output options.
+   * @return VTF data which can be parsed again with Vtf.
+   * @throws Errors::UnsupportedFormat The output format or face count cannot be written.
+   * @throws Errors::OutOfBoundsAccess The image has no pixels, or the source data is too short for its extent.
+   */
+  [[nodiscard]] std::vector<std::byte> toVtf(const WriterImage& image, const WriterOptions& options = {});
+}